@@ -0,0 +1,103 @@
+/**
+ * @file        base64_benchmarks.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "base64_benchmarks.h"
+#include "benchmark_helper.h"
+
+#include <random>
+#include <vector>
+
+#include <common/base64.h>
+
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
+#include <libKitsunemimiCrypto/common.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+static const std::vector<std::string> kernelNames = {"scalar", "sse41", "avx2", "avx512"};
+
+/**
+ * @brief create random data
+ */
+static std::string
+createRandomData(std::mt19937_64 &random,
+                 const uint64_t size)
+{
+    std::string data(size, '\0');
+    for(char &c : data) {
+        c = static_cast<char>(random() & 0xFF);
+    }
+    return data;
+}
+
+/**
+ * @brief compare the speed of the existing encoder with all kernels, which are supported by
+ *        the cpu. The correctness of the kernels is checked by the unit-tests.
+ */
+void
+runBase64Benchmarks()
+{
+    const Base64Kernel bestKernel = getBestBase64Kernel();
+
+    std::mt19937_64 random(1337);
+    const std::string data = createRandomData(random, 1024 * 1024);
+    const uint64_t iterations = 200;
+
+    runBenchmark("base64_encode/1m/kitsunemimi", iterations, [&data]()
+    {
+        std::string encoded;
+        Kitsunemimi::encodeBase64(encoded, data.c_str(), data.size());
+    });
+
+    std::string encodedData;
+    Kitsunemimi::encodeBase64(encodedData, data.c_str(), data.size());
+    runBenchmark("base64_decode/1m/kitsunemimi", iterations, [&encodedData]()
+    {
+        DataBuffer decoded;
+        Kitsunemimi::decodeBase64(decoded, encodedData);
+    });
+
+    for(uint32_t i = 0; i <= bestKernel; i++)
+    {
+        const Base64Kernel kernel = static_cast<Base64Kernel>(i);
+        setBase64Kernel(kernel);
+
+        runBenchmark("base64_encode/1m/" + kernelNames.at(i), iterations, [&data]()
+        {
+            std::string encoded;
+            appendBase64(encoded, data.c_str(), data.size());
+        });
+
+        runBenchmark("base64_decode/1m/" + kernelNames.at(i), iterations, [&encodedData]()
+        {
+            std::string decoded;
+            appendDecodedBase64(decoded, encodedData.c_str(), encodedData.size());
+        });
+    }
+
+    setBase64Kernel(bestKernel);
+}
+
+}  // namespace Misaki
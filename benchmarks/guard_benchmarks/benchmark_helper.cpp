@@ -0,0 +1,103 @@
+/**
+ * @file        benchmark_helper.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "benchmark_helper.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+static std::atomic<uint64_t> g_numberOfAllocations {0};
+
+/**
+ * global allocation-functions, which count every heap-allocation of the benchmark-process
+ */
+void*
+operator new(std::size_t size)
+{
+    g_numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace Misaki
+{
+
+/**
+ * @brief get number of heap-allocations since start of the process
+ */
+uint64_t
+getNumberOfAllocations()
+{
+    return g_numberOfAllocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief print result of a benchmark as single json-line
+ *
+ * @param result result to print
+ */
+void
+printResult(const BenchmarkResult &result)
+{
+    std::cout << "{\"name\":\"" << result.name << "\""
+              << ",\"iterations\":" << result.iterations
+              << ",\"ns_per_call\":" << result.nsPerCall
+              << ",\"allocations_per_call\":" << result.allocationsPerCall
+              << "}" << std::endl;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,88 @@
+/**
+ * @file        benchmark_helper.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_BENCHMARK_HELPER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_BENCHMARK_HELPER_H
+
+#include <string>
+#include <chrono>
+#include <stdint.h>
+
+namespace Misaki
+{
+
+struct BenchmarkResult
+{
+    std::string name = "";
+    uint64_t iterations = 0;
+    double nsPerCall = 0.0;
+    double allocationsPerCall = 0.0;
+};
+
+uint64_t getNumberOfAllocations();
+void printResult(const BenchmarkResult &result);
+
+/**
+ * @brief run a function multiple times and measure the time and the number of heap-allocations
+ *        per call
+ *
+ * @param name name of the benchmark in the output
+ * @param iterations number of calls
+ * @param function function to measure
+ *
+ * @return result of the benchmark
+ */
+template<typename FUNCTION>
+BenchmarkResult
+runBenchmark(const std::string &name,
+             const uint64_t iterations,
+             FUNCTION function)
+{
+    // warm up
+    function();
+
+    const uint64_t allocationsBefore = getNumberOfAllocations();
+    const auto start = std::chrono::steady_clock::now();
+
+    for(uint64_t i = 0; i < iterations; i++) {
+        function();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const uint64_t allocationsAfter = getNumberOfAllocations();
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerCall = std::chrono::duration<double, std::nano>(end - start).count()
+                       / static_cast<double>(iterations);
+    result.allocationsPerCall = static_cast<double>(allocationsAfter - allocationsBefore)
+                                / static_cast<double>(iterations);
+
+    printResult(result);
+
+    return result;
+}
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_BENCHMARK_HELPER_H
@@ -0,0 +1,193 @@
+/**
+ * @file        docu_benchmarks.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "docu_benchmarks.h"
+#include "benchmark_helper.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <documentation/api_docu_cache.h>
+#include <documentation/docu_renderer.h>
+#include <documentation/docu_stream.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiCrypto/common.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * Blossom with a typical set of fields, which is only used to fill the registry for the
+ * documentation-benchmarks.
+ */
+class SyntheticBlossom
+        : public Hanami::Blossom
+{
+public:
+    SyntheticBlossom()
+        : Hanami::Blossom("Synthetic blossom for the benchmarks of the documentation.")
+    {
+        registerInputField("name",
+                           Hanami::SAKURA_STRING_TYPE,
+                           true,
+                           "Name of the new object.");
+        addFieldRegex("name", "[a-zA-Z][a-zA-Z_0-9]*");
+        addFieldBorder("name", 4, 256);
+
+        registerInputField("count",
+                           Hanami::SAKURA_INT_TYPE,
+                           false,
+                           "Number of objects.");
+        addFieldDefault("count", new DataValue(1));
+        addFieldBorder("count", 1, 1000);
+
+        registerInputField("settings",
+                           Hanami::SAKURA_MAP_TYPE,
+                           false,
+                           "Additional settings of the object.");
+
+        registerOutputField("uuid",
+                            Hanami::SAKURA_STRING_TYPE,
+                            "UUID of the new object.");
+        registerOutputField("items",
+                            Hanami::SAKURA_ARRAY_TYPE,
+                            "List of all created items.");
+    }
+
+protected:
+    bool runTask(Hanami::BlossomIO &,
+                 const DataMap &,
+                 Hanami::BlossomStatus &,
+                 ErrorContainer &)
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief grow the registry of the messaging-interface up to the given number of endpoints.
+ *        Because endpoints can not be removed from the registry, the sizes have to be
+ *        requested in ascending order.
+ *
+ * @param numberOfEndpoints requested number of endpoints
+ */
+static void
+fillRegistry(const uint64_t numberOfEndpoints)
+{
+    HanamiMessaging* interface = HanamiMessaging::getInstance();
+    const std::string group = "benchmark";
+    const uint64_t numberOfBlossoms = 16;
+
+    static bool blossomsRegistered = false;
+    if(blossomsRegistered == false)
+    {
+        for(uint64_t i = 0; i < numberOfBlossoms; i++) {
+            interface->addBlossom(group, "blossom_" + std::to_string(i), new SyntheticBlossom());
+        }
+        blossomsRegistered = true;
+    }
+
+    for(uint64_t i = interface->endpointRules.size(); i < numberOfEndpoints; i++)
+    {
+        const std::string endpoint = "v1/benchmark/object_" + std::to_string(i);
+        const std::string blossomName = "blossom_" + std::to_string(i % numberOfBlossoms);
+
+        interface->addEndpoint(endpoint,
+                               Hanami::GET_TYPE,
+                               Hanami::BLOSSOM_TYPE,
+                               group,
+                               blossomName);
+        if(i % 2 == 0)
+        {
+            interface->addEndpoint(endpoint,
+                                   Hanami::POST_TYPE,
+                                   Hanami::BLOSSOM_TYPE,
+                                   group,
+                                   blossomName);
+        }
+    }
+}
+
+/**
+ * @brief render the documentation and convert it to base64 with registries of different sizes
+ */
+void
+runDocuBenchmarks()
+{
+    const std::vector<uint64_t> registrySizes = {10, 1000, 50000};
+
+    for(const uint64_t registrySize : registrySizes)
+    {
+        fillRegistry(registrySize);
+        ApiDocuCache::getInstance()->updateRegistryVersion();
+
+        // keep the runtime of the large registries within a few seconds
+        const uint64_t iterations = std::max<uint64_t>(3, 20000 / registrySize);
+        const std::string suffix = "/" + std::to_string(registrySize);
+
+        runBenchmark("docu_render/rst" + suffix, iterations, []()
+        {
+            std::string docu;
+            DocuRenderer<RstFormat>::render(docu, "benchmark");
+        });
+
+        runBenchmark("docu_render/md" + suffix, iterations, []()
+        {
+            std::string docu;
+            DocuRenderer<MdFormat>::render(docu, "benchmark");
+        });
+
+        std::string docu;
+        DocuRenderer<RstFormat>::render(docu, "benchmark");
+        runBenchmark("docu_base64/rst" + suffix, iterations, [&docu]()
+        {
+            std::string base64Docu;
+            encodeBase64(base64Docu, docu.c_str(), docu.size());
+        });
+
+        runBenchmark("docu_cached/rst" + suffix, iterations, []()
+        {
+            ErrorContainer error;
+            ApiDocuCache::getInstance()->getDocu(RST_DOCU_FORMAT,
+                                                 NO_DOCU_COMPRESSION,
+                                                 true,
+                                                 "benchmark",
+                                                 DocuFilter(),
+                                                 error);
+        });
+
+        runBenchmark("docu_stream/rst" + suffix, iterations, []()
+        {
+            std::string base64Docu;
+            DocuStream stream(base64Docu, true);
+            DocuRenderer<RstFormat>::render(stream, "benchmark");
+        });
+    }
+}
+
+}  // namespace Misaki
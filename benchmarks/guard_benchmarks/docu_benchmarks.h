@@ -1,11 +1,11 @@
 /**
- * @file        md_docu_generation.h
+ * @file        docu_benchmarks.h
  *
  * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
  *
  * @copyright   Apache License Version 2.0
  *
- *      Copyright 2021 Tobias Anker
+ *      Copyright 2022 Tobias Anker
  *
  *      Licensed under the Apache License, Version 2.0 (the "License");
  *      you may not use this file except in compliance with the License.
@@ -20,12 +20,14 @@
  *      limitations under the License.
  */
 
-#ifndef MD_DOCU_GENERATION_H
-#define MD_DOCU_GENERATION_H
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_BENCHMARKS_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_BENCHMARKS_H
 
-#include <string>
+namespace Misaki
+{
 
-void createMdDocumentation(std::string &docu,
-                           const std::string &localComponent);
+void runDocuBenchmarks();
 
-#endif // MD_DOCU_GENERATION_H
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_BENCHMARKS_H
@@ -0,0 +1,40 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_benchmarks.h"
+#include "docu_benchmarks.h"
+#include "base64_benchmarks.h"
+#include "validation_benchmarks.h"
+
+int main()
+{
+    Misaki::runTokenBenchmarks();
+    Misaki::runDocuBenchmarks();
+    Misaki::runBase64Benchmarks();
+
+    // the precompiled validator has to decide like the per-request validation
+    if(Misaki::runValidationBenchmarks() == false) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file        token_benchmarks.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_benchmarks.h"
+#include "benchmark_helper.h"
+
+#include <token/token_message.h>
+#include <token/token_cache.h>
+
+#include <libKitsunemimiJson/json_item.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief create a response like misaki sends it for a request of an internal token
+ */
+static std::string
+createTokenResponse()
+{
+    const std::string token = "eyJhbGciOiJIUzI1NiIsInR5cCI6IkpXVCJ9"
+                              ".eyJleHAiOjE2NzI1MzEyMDAsInNlcnZpY2VfbmFtZSI6ImF6dWtpIn0"
+                              ".mVd0cWcWmQvr6T0E8M8KZb3sYQAb6Ot3yB9Uy1L3h0Q";
+    return "{\"token\":\"" + token + "\"}";
+}
+
+/**
+ * @brief compare the old way to read the token with the full json-parser against the
+ *        allocation-free reader
+ */
+void
+runTokenBenchmarks()
+{
+    const std::string response = createTokenResponse();
+    const uint64_t iterations = 100000;
+
+    runBenchmark("token_response/json_parser", iterations, [&response]()
+    {
+        ErrorContainer error;
+        JsonItem jsonItem;
+        jsonItem.parse(response, error);
+        const std::string token = jsonItem.getItemContent()->toMap()->getStringByKey("token");
+    });
+
+    std::string token;
+    runBenchmark("token_response/direct_reader", iterations, [&response, &token]()
+    {
+        ErrorContainer error;
+        readTokenFromResponse(token, response, error);
+    });
+
+    runBenchmark("token_payload/expire_time", iterations, [&token]()
+    {
+        ErrorContainer error;
+        long expireTime = 0;
+        TokenCache::getExpireTime(expireTime, token, error);
+    });
+
+    std::string body;
+    runBenchmark("token_request/create_body", iterations, [&body]()
+    {
+        createTokenRequestBody(body, "azuki");
+    });
+}
+
+}  // namespace Misaki
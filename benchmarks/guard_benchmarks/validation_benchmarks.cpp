@@ -0,0 +1,283 @@
+/**
+ * @file        validation_benchmarks.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "validation_benchmarks.h"
+#include "benchmark_helper.h"
+
+#include <iostream>
+#include <vector>
+
+#include <validation/request_validator.h>
+#include <libMisakiGuard/misaki_input.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * Blossom with all types of field-checks, which is only used for the validation-benchmarks.
+ */
+class ValidationBlossom
+        : public Hanami::Blossom
+{
+public:
+    ValidationBlossom()
+        : Hanami::Blossom("Synthetic blossom for the benchmarks of the request-validation.")
+    {
+        registerInputField("name",
+                           Hanami::SAKURA_STRING_TYPE,
+                           true,
+                           "Name of the new object.");
+        addFieldRegex("name", "[a-zA-Z][a-zA-Z_0-9]*");
+        addFieldBorder("name", 4, 256);
+
+        registerInputField("project_id",
+                           Hanami::SAKURA_STRING_TYPE,
+                           true,
+                           "ID of the project.");
+        addFieldRegex("project_id", "[a-f0-9]{8}-[a-f0-9]{4}-[a-f0-9]{4}-[a-f0-9]{4}-[a-f0-9]{12}");
+
+        registerInputField("count",
+                           Hanami::SAKURA_INT_TYPE,
+                           false,
+                           "Number of objects.");
+        addFieldBorder("count", 1, 1000);
+
+        registerInputField("mode",
+                           Hanami::SAKURA_STRING_TYPE,
+                           false,
+                           "Mode of the creation.");
+        addFieldMatch("mode", new DataValue("fast"));
+
+        registerInputField("ratio",
+                           Hanami::SAKURA_FLOAT_TYPE,
+                           false,
+                           "Ratio of the object.");
+
+        registerInputField("dry_run",
+                           Hanami::SAKURA_BOOL_TYPE,
+                           false,
+                           "Only check the request.");
+
+        registerInputField("tags",
+                           Hanami::SAKURA_ARRAY_TYPE,
+                           false,
+                           "Tags of the object.");
+
+        registerInputField("settings",
+                           Hanami::SAKURA_MAP_TYPE,
+                           false,
+                           "Additional settings of the object.");
+    }
+
+protected:
+    bool runTask(Hanami::BlossomIO &,
+                 const DataMap &,
+                 Hanami::BlossomStatus &,
+                 ErrorContainer &)
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief check a request with the input-validation of hanami, which is done, when the blossom
+ *        is triggered. The blossom of the benchmarks does nothing, so the result only depends
+ *        on the validation, but the time also contains the copy of the input and the call of
+ *        the blossom.
+ *
+ * @param group group of the blossom
+ * @param name name of the blossom
+ * @param input input-values of the request
+ * @param error reference for error-output
+ *
+ * @return true, if the input is valid, else false
+ */
+static bool
+validateWithBlossom(const std::string &group,
+                    const std::string &name,
+                    const DataMap &input,
+                    ErrorContainer &error)
+{
+    DataMap result;
+    DataMap context;
+    Hanami::BlossomStatus status;
+
+    return HanamiMessaging::getInstance()->triggerBlossom(result,
+                                                          name,
+                                                          group,
+                                                          context,
+                                                          input,
+                                                          status,
+                                                          error);
+}
+
+/**
+ * @brief create the input of a request for the benchmarks
+ *
+ * @param name value of the name-field
+ * @param count value of the count-field
+ *
+ * @return new input-map, which has to be deleted by the caller
+ */
+static DataMap*
+createInput(const std::string &name,
+            const long count)
+{
+    DataMap* input = new DataMap();
+    input->insert("name", new DataValue(name));
+    input->insert("project_id", new DataValue("0a1b2c3d-4e5f-6a7b-8c9d-0e1f2a3b4c5d"));
+    input->insert("count", new DataValue(count));
+    input->insert("mode", new DataValue("fast"));
+    input->insert("ratio", new DataValue(0.5));
+    input->insert("dry_run", new DataValue(false));
+
+    DataArray* tags = new DataArray();
+    tags->append(new DataValue("benchmark"));
+    input->insert("tags", tags);
+    input->insert("settings", new DataMap());
+
+    return input;
+}
+
+/**
+ * @brief check that the precompiled validator has the same results like the input-validation
+ *        of hanami and compare their speed
+ *
+ * @return false, if the precompiled validator has a different result for at least one input
+ */
+bool
+runValidationBenchmarks()
+{
+    HanamiMessaging* interface = HanamiMessaging::getInstance();
+    const std::string group = "validation_benchmark";
+    const std::string blossomName = "create_object";
+    const std::string endpoint = "v1/benchmark/validation";
+
+    interface->addBlossom(group, blossomName, new ValidationBlossom());
+    interface->addEndpoint(endpoint,
+                           Hanami::POST_TYPE,
+                           Hanami::BLOSSOM_TYPE,
+                           group,
+                           blossomName);
+
+    ErrorContainer error;
+    if(initRequestValidators(error) == false) {
+        return false;
+    }
+
+    const Hanami::Blossom* blossom = interface->getBlossom(group, blossomName);
+    const std::map<std::string, Hanami::FieldDef> &defMap = *blossom->getInputValidationMap();
+    RequestValidator validator;
+    if(validator.compile(defMap, error) == false) {
+        return false;
+    }
+
+    // valid input and one input for each type of rejection
+    std::vector<std::pair<std::string, DataMap*>> inputs;
+    inputs.emplace_back("valid", createInput("benchmark_object", 10));
+    inputs.emplace_back("regex", createInput("1_benchmark_object", 10));
+    inputs.emplace_back("length", createInput("obj", 10));
+    inputs.emplace_back("border", createInput("benchmark_object", 5000));
+    inputs.emplace_back("unknown", createInput("benchmark_object", 10));
+    inputs.back().second->insert("color", new DataValue("red"));
+    inputs.emplace_back("missing", createInput("benchmark_object", 10));
+    inputs.back().second->remove("project_id");
+    inputs.emplace_back("type", createInput("benchmark_object", 10));
+    inputs.back().second->insert("dry_run", new DataValue("no"));
+    inputs.emplace_back("match", createInput("benchmark_object", 10));
+    inputs.back().second->insert("mode", new DataValue("slow"));
+
+    bool allEqual = true;
+    for(const auto& [inputName, input] : inputs)
+    {
+        ErrorContainer blossomError;
+        ErrorContainer compiledError;
+        ErrorContainer endpointError;
+        const bool blossomResult = validateWithBlossom(group, blossomName, *input, blossomError);
+        const bool compiledResult = validator.validate(*input, compiledError);
+        const bool endpointResult = checkRequestInput(endpoint,
+                                                      Hanami::POST_TYPE,
+                                                      *input,
+                                                      endpointError);
+
+        const bool isEqual = blossomResult == compiledResult
+                             && compiledResult == endpointResult
+                             && blossomResult == (inputName == "valid");
+        allEqual = allEqual && isEqual;
+        std::cout << "{\"name\":\"validation_check/" << inputName << "\""
+                  << ",\"equal\":" << (isEqual ? "true" : "false")
+                  << "}" << std::endl;
+    }
+
+    const uint64_t iterations = 10000;
+    const DataMap* validInput = inputs.at(0).second;
+    const DataMap* invalidInput = inputs.at(1).second;
+
+    runBenchmark("request_validation/blossom/valid",
+                 iterations,
+                 [&group, &blossomName, validInput]()
+    {
+        ErrorContainer error;
+        validateWithBlossom(group, blossomName, *validInput, error);
+    });
+
+    runBenchmark("request_validation/compiled/valid", iterations, [&validator, validInput]()
+    {
+        ErrorContainer error;
+        validator.validate(*validInput, error);
+    });
+
+    runBenchmark("request_validation/endpoint/valid", iterations, [&endpoint, validInput]()
+    {
+        ErrorContainer error;
+        checkRequestInput(endpoint, Hanami::POST_TYPE, *validInput, error);
+    });
+
+    runBenchmark("request_validation/blossom/regex",
+                 iterations,
+                 [&group, &blossomName, invalidInput]()
+    {
+        ErrorContainer error;
+        validateWithBlossom(group, blossomName, *invalidInput, error);
+    });
+
+    runBenchmark("request_validation/compiled/regex", iterations, [&validator, invalidInput]()
+    {
+        ErrorContainer error;
+        validator.validate(*invalidInput, error);
+    });
+
+    for(const auto& [inputName, input] : inputs) {
+        delete input;
+    }
+
+    return allEqual;
+}
+
+}  // namespace Misaki
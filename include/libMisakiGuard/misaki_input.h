@@ -24,17 +24,126 @@
 #define KITSUNEMIMI_HANAMI_MISAKI_INPUT_H
 
 #include <string>
+#include <vector>
+#include <map>
+#include <future>
+#include <functional>
+#include <memory>
 
 #include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiJson/json_item.h>
+#include <libKitsunemimiHanamiCommon/enums.h>
 
 namespace Misaki
 {
 
+struct TokenClaims
+{
+    std::string name = "";
+    std::string userId = "";
+    std::vector<std::string> roles;
+    bool isAdmin = false;
+    long expireTime = 0;
+    std::string tokenId = "";
+    Kitsunemimi::JsonItem payload;
+};
+
+typedef std::shared_ptr<const TokenClaims> TokenClaimsPtr;
+
+struct InternalTokenResult
+{
+    bool success = false;
+    std::string token = "";
+    Kitsunemimi::ErrorContainer error;
+};
+
+typedef std::function<void(const InternalTokenResult &result)> InternalTokenCallback;
+
+struct MisakiCallConfig
+{
+    uint32_t deadlineMs = 5000;
+    uint32_t maxRetries = 3;
+    uint32_t initialBackoffMs = 100;
+    uint32_t maxBackoffMs = 2000;
+    uint32_t breakerFailureThreshold = 5;
+    uint32_t breakerOpenTimeMs = 10000;
+};
+
+enum CircuitState
+{
+    CIRCUIT_CLOSED = 0,
+    CIRCUIT_OPEN = 1,
+    CIRCUIT_HALF_OPEN = 2,
+};
+
+typedef std::function<void(const CircuitState oldState,
+                           const CircuitState newState)> CircuitStateCallback;
+
+struct VerifiedTokenCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
+
 bool initMisakiBlossoms();
+void shutdownMisakiGuard();
 
 bool getInternalToken(std::string &token,
                       const std::string &componentName,
                       Kitsunemimi::ErrorContainer &error);
+bool getInternalTokens(std::map<std::string, InternalTokenResult> &results,
+                       const std::vector<std::string> &componentNames);
+std::shared_future<InternalTokenResult> getInternalTokenAsync(const std::string &componentName);
+void getInternalTokenAsync(const std::string &componentName,
+                           const InternalTokenCallback &callback);
+
+void setMisakiCallConfig(const MisakiCallConfig &config);
+CircuitState getMisakiCircuitState();
+void setMisakiCircuitStateCallback(const CircuitStateCallback &callback);
+
+void setInternalTokenSafetyMargin(const uint32_t seconds);
+bool initInternalTokenRefresher(const uint32_t refreshMargin = 300);
+void clearInternalTokenCache();
+
+bool initTokenValidation(const std::string &tokenKey,
+                         Kitsunemimi::ErrorContainer &error);
+bool initTokenValidationFromFile(const std::string &keyFilePath,
+                                 const bool watchFile,
+                                 Kitsunemimi::ErrorContainer &error);
+bool initTokenValidationFromMisaki(Kitsunemimi::ErrorContainer &error);
+bool initTokenRevocation(const uint32_t pullIntervalSec,
+                         Kitsunemimi::ErrorContainer &error);
+bool updateTokenRevocations(const std::string &deltaJson,
+                            Kitsunemimi::ErrorContainer &error);
+bool validateToken(TokenClaims &claims,
+                   const std::string &token,
+                   Kitsunemimi::ErrorContainer &error);
+bool validateToken(TokenClaimsPtr &claims,
+                   const std::string &token,
+                   Kitsunemimi::ErrorContainer &error);
+void setVerifiedTokenCacheSize(const uint64_t maxNumberOfTokens);
+void getVerifiedTokenCacheStats(VerifiedTokenCacheStats &stats);
+
+bool checkPermission(bool &isAllowed,
+                     const std::string &token,
+                     const std::string &endpoint,
+                     const Kitsunemimi::Hanami::HttpRequestType httpType,
+                     Kitsunemimi::ErrorContainer &error);
+void setPermissionCacheTtl(const uint32_t seconds);
+void invalidatePermissionCache();
+void invalidatePermissionCacheForEndpoint(const std::string &endpoint);
+
+bool initPolicy(Kitsunemimi::ErrorContainer &error);
+bool updatePolicy(const std::string &policyJson,
+                  Kitsunemimi::ErrorContainer &error);
+
+bool initRequestValidators(Kitsunemimi::ErrorContainer &error);
+bool checkRequestInput(const std::string &endpoint,
+                       const Kitsunemimi::Hanami::HttpRequestType httpType,
+                       const Kitsunemimi::DataMap &input,
+                       Kitsunemimi::ErrorContainer &error);
 
 }
 
@@ -9,3 +9,14 @@ run_tests {
     tests.depends = src
 }
 
+run_benchmarks {
+    SUBDIRS += benchmarks
+
+    benchmarks.depends = src
+}
+
+run_tools {
+    SUBDIRS += tools
+
+    tools.depends = src
+}
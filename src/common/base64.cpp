@@ -0,0 +1,765 @@
+/**
+ * @file        base64.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <common/base64.h>
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MISAKI_BASE64_X86
+#include <immintrin.h>
+#endif
+
+namespace Misaki
+{
+
+//==================================================================================================
+// tables
+//==================================================================================================
+
+static const uint8_t INVALID_CHAR = 0xFF;
+
+/**
+ * Lookup-tables of an alphabet. Standard-base64 uses '+' and '/' for the values 62 and 63,
+ * while base64url uses '-' and '_'.
+ */
+struct AlphabetTables
+{
+    char encode[64];
+    uint8_t decode[256];
+    char char62;
+    char char63;
+
+    AlphabetTables(const char c62, const char c63)
+    {
+        const char* base = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+        for(uint32_t i = 0; i < 62; i++) {
+            encode[i] = base[i];
+        }
+        encode[62] = c62;
+        encode[63] = c63;
+        char62 = c62;
+        char63 = c63;
+
+        for(uint32_t i = 0; i < 256; i++) {
+            decode[i] = INVALID_CHAR;
+        }
+        for(uint32_t i = 0; i < 64; i++) {
+            decode[static_cast<uint8_t>(encode[i])] = static_cast<uint8_t>(i);
+        }
+    }
+};
+
+static const AlphabetTables&
+getTables(const Base64Alphabet alphabet)
+{
+    static const AlphabetTables standardTables('+', '/');
+    static const AlphabetTables urlTables('-', '_');
+
+    if(alphabet == BASE64_URL) {
+        return urlTables;
+    }
+    return standardTables;
+}
+
+//==================================================================================================
+// scalar kernels, which are also used for the tails of the vectorized kernels
+//==================================================================================================
+
+/**
+ * @brief encode complete 3-byte-groups and the optional last incomplete group
+ *
+ * @return number of written characters
+ */
+static uint64_t
+encodeScalar(char* output,
+             const uint8_t* input,
+             const uint64_t size,
+             const AlphabetTables &tables,
+             const bool withPadding)
+{
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    for(; inPos + 3 <= size; inPos += 3)
+    {
+        const uint32_t block = (static_cast<uint32_t>(input[inPos]) << 16)
+                               | (static_cast<uint32_t>(input[inPos + 1]) << 8)
+                               | static_cast<uint32_t>(input[inPos + 2]);
+        output[outPos++] = tables.encode[(block >> 18) & 0x3F];
+        output[outPos++] = tables.encode[(block >> 12) & 0x3F];
+        output[outPos++] = tables.encode[(block >> 6) & 0x3F];
+        output[outPos++] = tables.encode[block & 0x3F];
+    }
+
+    const uint64_t rest = size - inPos;
+    if(rest > 0)
+    {
+        uint32_t block = static_cast<uint32_t>(input[inPos]) << 16;
+        if(rest == 2) {
+            block |= static_cast<uint32_t>(input[inPos + 1]) << 8;
+        }
+
+        output[outPos++] = tables.encode[(block >> 18) & 0x3F];
+        output[outPos++] = tables.encode[(block >> 12) & 0x3F];
+        if(rest == 2) {
+            output[outPos++] = tables.encode[(block >> 6) & 0x3F];
+        } else if(withPadding) {
+            output[outPos++] = '=';
+        }
+        if(withPadding) {
+            output[outPos++] = '=';
+        }
+    }
+
+    return outPos;
+}
+
+/**
+ * @brief decode characters without padding
+ *
+ * @return number of written bytes or -1, if the input is invalid
+ */
+static int64_t
+decodeScalar(uint8_t* output,
+             const char* input,
+             const uint64_t size,
+             const AlphabetTables &tables)
+{
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    for(; inPos + 4 <= size; inPos += 4)
+    {
+        const uint32_t a = tables.decode[static_cast<uint8_t>(input[inPos])];
+        const uint32_t b = tables.decode[static_cast<uint8_t>(input[inPos + 1])];
+        const uint32_t c = tables.decode[static_cast<uint8_t>(input[inPos + 2])];
+        const uint32_t d = tables.decode[static_cast<uint8_t>(input[inPos + 3])];
+        // valid values have at most 6 bits, while invalid ones are 0xFF
+        if((a | b | c | d) > 63) {
+            return -1;
+        }
+
+        const uint32_t block = (a << 18) | (b << 12) | (c << 6) | d;
+        output[outPos++] = static_cast<uint8_t>(block >> 16);
+        output[outPos++] = static_cast<uint8_t>(block >> 8);
+        output[outPos++] = static_cast<uint8_t>(block);
+    }
+
+    // a single remaining character can not be a valid base64-string
+    const uint64_t rest = size - inPos;
+    if(rest == 1) {
+        return -1;
+    }
+    if(rest > 1)
+    {
+        uint32_t block = 0;
+        for(uint64_t i = 0; i < rest; i++)
+        {
+            const uint32_t value = tables.decode[static_cast<uint8_t>(input[inPos + i])];
+            if(value == INVALID_CHAR) {
+                return -1;
+            }
+            block |= value << (18 - 6 * i);
+        }
+
+        // the bits after the last decoded byte must be zero, because otherwise different
+        // strings would decode to the same data
+        const uint32_t unusedBits = rest == 2 ? (block & 0xFFFF) : (block & 0xFF);
+        if(unusedBits != 0) {
+            return -1;
+        }
+
+        output[outPos++] = static_cast<uint8_t>(block >> 16);
+        if(rest == 3) {
+            output[outPos++] = static_cast<uint8_t>(block >> 8);
+        }
+    }
+
+    return static_cast<int64_t>(outPos);
+}
+
+#ifdef MISAKI_BASE64_X86
+
+//==================================================================================================
+// SSE4.1 kernels (16 characters per step)
+//==================================================================================================
+
+/**
+ * @brief split 12 bytes, which are spread over 4 bytes per 3 input-bytes, into 16 6-bit values
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i
+splitToIndices_sse41(const __m128i input)
+{
+    const __m128i shuffled = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10,
+                                                                  7, 8, 6, 7,
+                                                                  4, 5, 3, 4,
+                                                                  1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(shuffled, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(shuffled, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+/**
+ * @brief convert 6-bit values into characters by adding an offset per value-range
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i
+indicesToChars_sse41(const __m128i indices,
+                     const __m128i shiftLut)
+{
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    result = _mm_shuffle_epi8(shiftLut, result);
+    return _mm_add_epi8(result, indices);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i
+getShiftLut_sse41(const AlphabetTables &tables)
+{
+    return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                         '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                         static_cast<char>(tables.char62 - 62),
+                         static_cast<char>(tables.char63 - 63),
+                         'A', 0, 0);
+}
+
+__attribute__((target("sse4.1")))
+static uint64_t
+encode_sse41(char* output,
+             const uint8_t* input,
+             const uint64_t size,
+             const AlphabetTables &tables,
+             uint64_t &consumed)
+{
+    const __m128i shiftLut = getShiftLut_sse41(tables);
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    // 16 bytes are loaded, but only 12 are used
+    for(; inPos + 16 <= size; inPos += 12)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + inPos));
+        const __m128i chars = indicesToChars_sse41(splitToIndices_sse41(in), shiftLut);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + outPos), chars);
+        outPos += 16;
+    }
+
+    consumed = inPos;
+    return outPos;
+}
+
+/**
+ * @brief convert characters into 6-bit values by range-checks, which works for both alphabets
+ *
+ * @return false, if at least one character is invalid
+ */
+__attribute__((target("sse4.1")))
+static inline bool
+charsToValues_sse41(__m128i &values,
+                    const __m128i in,
+                    const AlphabetTables &tables)
+{
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), in));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), in));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+    const __m128i is62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(tables.char62));
+    const __m128i is63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(tables.char63));
+
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                       _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+    if(_mm_movemask_epi8(valid) != 0xFFFF) {
+        return false;
+    }
+
+    __m128i offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    offset = _mm_or_si128(offset, _mm_and_si128(is62, _mm_set1_epi8(62 - tables.char62)));
+    offset = _mm_or_si128(offset, _mm_and_si128(is63, _mm_set1_epi8(63 - tables.char63)));
+    values = _mm_add_epi8(in, offset);
+
+    return true;
+}
+
+/**
+ * @brief merge 4 6-bit values per 32-bit word into 3 bytes at the lower end of the word
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i
+packValues_sse41(const __m128i values)
+{
+    const __m128i mergedPairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i merged = _mm_madd_epi16(mergedPairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                                  8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("sse4.1")))
+static int64_t
+decode_sse41(uint8_t* output,
+             const char* input,
+             const uint64_t size,
+             const AlphabetTables &tables,
+             uint64_t &consumed)
+{
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    // 16 bytes are written, but only 12 are used, which is covered by the output-reserve
+    for(; inPos + 16 <= size; inPos += 16)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + inPos));
+        __m128i values;
+        if(charsToValues_sse41(values, in, tables) == false) {
+            return -1;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + outPos), packValues_sse41(values));
+        outPos += 12;
+    }
+
+    consumed = inPos;
+    return static_cast<int64_t>(outPos);
+}
+
+//==================================================================================================
+// AVX2 kernels (32 characters per step)
+//==================================================================================================
+
+__attribute__((target("avx2")))
+static uint64_t
+encode_avx2(char* output,
+            const uint8_t* input,
+            const uint64_t size,
+            const AlphabetTables &tables,
+            uint64_t &consumed)
+{
+    const __m128i shiftLut128 = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52,
+                                              static_cast<char>(tables.char62 - 62),
+                                              static_cast<char>(tables.char63 - 63),
+                                              'A', 0, 0);
+    const __m256i shiftLut = _mm256_broadcastsi128_si256(shiftLut128);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10,
+                                                                     7, 8, 6, 7,
+                                                                     4, 5, 3, 4,
+                                                                     1, 2, 0, 1));
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    // each lane gets 12 bytes, while the second load reads 16 bytes starting at byte 12
+    for(; inPos + 28 <= size; inPos += 24)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + inPos));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + inPos + 12));
+        const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        const __m256i shuffled = _mm256_shuffle_epi8(in, shuffle);
+        const __m256i t0 = _mm256_and_si256(shuffled, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(shuffled, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_shuffle_epi8(shiftLut, result);
+        result = _mm256_add_epi8(result, indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + outPos), result);
+        outPos += 32;
+    }
+
+    consumed = inPos;
+    return outPos;
+}
+
+__attribute__((target("avx2")))
+static int64_t
+decode_avx2(uint8_t* output,
+            const char* input,
+            const uint64_t size,
+            const AlphabetTables &tables,
+            uint64_t &consumed)
+{
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    for(; inPos + 32 <= size; inPos += 32)
+    {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + inPos));
+
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+        const __m256i is62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(tables.char62));
+        const __m256i is63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(tables.char63));
+
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                              _mm256_or_si256(digit,
+                                                              _mm256_or_si256(is62, is63)));
+        if(_mm256_movemask_epi8(valid) != -1) {
+            return -1;
+        }
+
+        __m256i offset = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+        offset = _mm256_or_si256(offset, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        offset = _mm256_or_si256(offset, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        offset = _mm256_or_si256(offset,
+                                 _mm256_and_si256(is62, _mm256_set1_epi8(62 - tables.char62)));
+        offset = _mm256_or_si256(offset,
+                                 _mm256_and_si256(is63, _mm256_set1_epi8(63 - tables.char63)));
+        const __m256i values = _mm256_add_epi8(in, offset);
+
+        // pack each lane to 12 bytes and move the two halfs together
+        const __m256i mergedPairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i merged = _mm256_madd_epi16(mergedPairs, _mm256_set1_epi32(0x00011000));
+        const __m256i packedLanes = _mm256_shuffle_epi8(
+                    merged,
+                    _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                     2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        const __m256i packed = _mm256_permutevar8x32_epi32(packedLanes,
+                                                           _mm256_setr_epi32(0, 1, 2, 4,
+                                                                             5, 6, 7, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + outPos), packed);
+        outPos += 24;
+    }
+
+    consumed = inPos;
+    return static_cast<int64_t>(outPos);
+}
+
+//==================================================================================================
+// AVX-512 kernels with VBMI (64 characters per step)
+//==================================================================================================
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static uint64_t
+encode_avx512(char* output,
+              const uint8_t* input,
+              const uint64_t size,
+              const AlphabetTables &tables,
+              uint64_t &consumed)
+{
+    // spread each 3 input-bytes over 4 bytes in the order [b1, b0, b2, b1]
+    const __m512i shuffleInput = _mm512_setr_epi32(0x01020001, 0x04050304, 0x07080607,
+                                                   0x0a0b090a, 0x0d0e0c0d, 0x10110f10,
+                                                   0x13141213, 0x16171516, 0x191a1819,
+                                                   0x1c1d1b1c, 0x1f201e1f, 0x22232122,
+                                                   0x25262425, 0x28292728, 0x2b2c2a2b,
+                                                   0x2e2f2d2e);
+    const __m512i shifts = _mm512_set1_epi64(0x3036242a1016040a);
+    const __m512i lookup = _mm512_loadu_si512(tables.encode);
+
+    const __mmask64 all = ~static_cast<__mmask64>(0);
+
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    // 64 bytes are loaded, but only 48 are used. The masked variants of the intrinsics are
+    // used, because the unmasked ones trigger false uninitialized-warnings in gcc 12.
+    for(; inPos + 64 <= size; inPos += 48)
+    {
+        const __m512i in = _mm512_loadu_si512(input + inPos);
+        const __m512i spread = _mm512_maskz_permutexvar_epi8(all, shuffleInput, in);
+        const __m512i indices = _mm512_maskz_multishift_epi64_epi8(all, shifts, spread);
+        const __m512i chars = _mm512_maskz_permutexvar_epi8(all, indices, lookup);
+
+        _mm512_storeu_si512(output + outPos, chars);
+        outPos += 64;
+    }
+
+    consumed = inPos;
+    return outPos;
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static int64_t
+decode_avx512(uint8_t* output,
+              const char* input,
+              const uint64_t size,
+              const AlphabetTables &tables,
+              uint64_t &consumed)
+{
+    // table for the 128 ascii-characters, where invalid characters have the highest bit set
+    alignas(64) uint8_t asciiTable[128];
+    for(uint32_t i = 0; i < 128; i++)
+    {
+        const uint8_t value = tables.decode[i];
+        asciiTable[i] = value == INVALID_CHAR ? 0x80 : value;
+    }
+    const __m512i lookupLow = _mm512_load_si512(asciiTable);
+    const __m512i lookupHigh = _mm512_load_si512(asciiTable + 64);
+
+    // output-byte j is byte (2 - j % 3) of the 32-bit word j / 3
+    alignas(64) uint8_t packTable[64];
+    for(uint32_t j = 0; j < 64; j++) {
+        packTable[j] = j < 48 ? static_cast<uint8_t>(4 * (j / 3) + (2 - j % 3)) : 0;
+    }
+    const __m512i pack = _mm512_load_si512(packTable);
+    const __mmask64 all = ~static_cast<__mmask64>(0);
+
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+
+    for(; inPos + 64 <= size; inPos += 64)
+    {
+        const __m512i in = _mm512_loadu_si512(input + inPos);
+        const __m512i values = _mm512_permutex2var_epi8(lookupLow, in, lookupHigh);
+
+        // non-ascii-characters have the highest bit in the input, invalid ones in the values
+        if(_mm512_movepi8_mask(_mm512_or_si512(values, in)) != 0) {
+            return -1;
+        }
+
+        const __m512i mergedPairs = _mm512_maddubs_epi16(values, _mm512_set1_epi32(0x01400140));
+        const __m512i merged = _mm512_madd_epi16(mergedPairs, _mm512_set1_epi32(0x00011000));
+        const __m512i packed = _mm512_maskz_permutexvar_epi8(all, pack, merged);
+
+        _mm512_storeu_si512(output + outPos, packed);
+        outPos += 48;
+    }
+
+    consumed = inPos;
+    return static_cast<int64_t>(outPos);
+}
+
+#endif // MISAKI_BASE64_X86
+
+//==================================================================================================
+// dispatch
+//==================================================================================================
+
+/**
+ * @brief get the fastest kernel, which is supported by the cpu
+ *
+ * @return best kernel
+ */
+Base64Kernel
+getBestBase64Kernel()
+{
+#ifdef MISAKI_BASE64_X86
+    static const Base64Kernel bestKernel = []()
+    {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f")
+                && __builtin_cpu_supports("avx512bw")
+                && __builtin_cpu_supports("avx512vbmi"))
+        {
+            return BASE64_AVX512_KERNEL;
+        }
+        if(__builtin_cpu_supports("avx2")) {
+            return BASE64_AVX2_KERNEL;
+        }
+        if(__builtin_cpu_supports("sse4.1")) {
+            return BASE64_SSE41_KERNEL;
+        }
+        return BASE64_SCALAR_KERNEL;
+    }();
+    return bestKernel;
+#else
+    return BASE64_SCALAR_KERNEL;
+#endif
+}
+
+static std::atomic<uint32_t>&
+getActiveKernel()
+{
+    static std::atomic<uint32_t> activeKernel {static_cast<uint32_t>(getBestBase64Kernel())};
+    return activeKernel;
+}
+
+/**
+ * @brief get kernel, which is used at the moment
+ *
+ * @return active kernel
+ */
+Base64Kernel
+getBase64Kernel()
+{
+    return static_cast<Base64Kernel>(getActiveKernel().load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief select a kernel, for example to compare the kernels in the benchmarks
+ *
+ * @param kernel new kernel
+ *
+ * @return false, if the kernel is not supported by the cpu, else true
+ */
+bool
+setBase64Kernel(const Base64Kernel kernel)
+{
+    if(kernel > getBestBase64Kernel()) {
+        return false;
+    }
+
+    getActiveKernel().store(static_cast<uint32_t>(kernel), std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief encode data and append it to a string. Standard-base64 is padded with '=', while
+ *        base64url is not padded, like it is used within jwt-tokens.
+ *
+ * @param output string, where the encoded data are appended
+ * @param data pointer to the data
+ * @param size number of bytes
+ * @param alphabet alphabet of the encoding
+ */
+void
+appendBase64(std::string &output,
+             const void* data,
+             const uint64_t size,
+             const Base64Alphabet alphabet)
+{
+    const AlphabetTables &tables = getTables(alphabet);
+    const bool withPadding = alphabet == BASE64_STANDARD;
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+
+    const uint64_t oldSize = output.size();
+    output.resize(oldSize + ((size + 2) / 3) * 4);
+    char* target = &output[oldSize];
+
+    uint64_t consumed = 0;
+    uint64_t written = 0;
+
+#ifdef MISAKI_BASE64_X86
+    switch(getBase64Kernel())
+    {
+        case BASE64_AVX512_KERNEL:
+            written = encode_avx512(target, input, size, tables, consumed);
+            break;
+        case BASE64_AVX2_KERNEL:
+            written = encode_avx2(target, input, size, tables, consumed);
+            break;
+        case BASE64_SSE41_KERNEL:
+            written = encode_sse41(target, input, size, tables, consumed);
+            break;
+        default:
+            break;
+    }
+#endif
+
+    written += encodeScalar(target + written,
+                            input + consumed,
+                            size - consumed,
+                            tables,
+                            withPadding);
+    output.resize(oldSize + written);
+}
+
+/**
+ * @brief decode a base64-string and append the result to a string. Padding at the end is
+ *        optional for both alphabets, but if it exists, it must complete the last block of
+ *        4 characters. The unused bits of the last character must be zero.
+ *
+ * @param output string, where the decoded data are appended
+ * @param data pointer to the encoded characters
+ * @param size number of characters
+ * @param alphabet alphabet of the encoding
+ *
+ * @return false, if the input is not valid for the alphabet, else true
+ */
+bool
+appendDecodedBase64(std::string &output,
+                    const char* data,
+                    const uint64_t size,
+                    const Base64Alphabet alphabet)
+{
+    const AlphabetTables &tables = getTables(alphabet);
+
+    // remove padding
+    uint64_t length = size;
+    if(length > 0 && data[length - 1] == '=') {
+        length--;
+    }
+    if(length > 0 && data[length - 1] == '=') {
+        length--;
+    }
+
+    // padding is only valid to fill up the last block
+    if(length != size
+            && (size % 4 != 0 || length % 4 < 2))
+    {
+        return false;
+    }
+
+    // the vectorized kernels write up to 16 bytes more than they decode
+    const uint64_t oldSize = output.size();
+    output.resize(oldSize + (length / 4) * 3 + 3 + 16);
+    uint8_t* target = reinterpret_cast<uint8_t*>(&output[oldSize]);
+
+    uint64_t consumed = 0;
+    int64_t written = 0;
+
+#ifdef MISAKI_BASE64_X86
+    switch(getBase64Kernel())
+    {
+        case BASE64_AVX512_KERNEL:
+            written = decode_avx512(target, data, length, tables, consumed);
+            break;
+        case BASE64_AVX2_KERNEL:
+            written = decode_avx2(target, data, length, tables, consumed);
+            break;
+        case BASE64_SSE41_KERNEL:
+            written = decode_sse41(target, data, length, tables, consumed);
+            break;
+        default:
+            break;
+    }
+#endif
+
+    int64_t tailWritten = -1;
+    if(written >= 0)
+    {
+        tailWritten = decodeScalar(target + written,
+                                   data + consumed,
+                                   length - consumed,
+                                   tables);
+    }
+    if(tailWritten < 0)
+    {
+        output.resize(oldSize);
+        return false;
+    }
+
+    output.resize(oldSize + static_cast<uint64_t>(written + tailWritten));
+
+    return true;
+}
+
+}  // namespace Misaki
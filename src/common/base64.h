@@ -0,0 +1,61 @@
+/**
+ * @file        base64.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_BASE64_H
+#define KITSUNEMIMI_HANAMI_MISAKI_BASE64_H
+
+#include <string>
+#include <stdint.h>
+
+namespace Misaki
+{
+
+enum Base64Alphabet
+{
+    BASE64_STANDARD = 0,
+    BASE64_URL = 1,
+};
+
+enum Base64Kernel
+{
+    BASE64_SCALAR_KERNEL = 0,
+    BASE64_SSE41_KERNEL = 1,
+    BASE64_AVX2_KERNEL = 2,
+    BASE64_AVX512_KERNEL = 3,
+};
+
+void appendBase64(std::string &output,
+                  const void* data,
+                  const uint64_t size,
+                  const Base64Alphabet alphabet = BASE64_STANDARD);
+bool appendDecodedBase64(std::string &output,
+                         const char* data,
+                         const uint64_t size,
+                         const Base64Alphabet alphabet = BASE64_STANDARD);
+
+Base64Kernel getBestBase64Kernel();
+Base64Kernel getBase64Kernel();
+bool setBase64Kernel(const Base64Kernel kernel);
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_BASE64_H
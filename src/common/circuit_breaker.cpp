@@ -0,0 +1,220 @@
+/**
+ * @file        circuit_breaker.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <common/circuit_breaker.h>
+
+namespace Misaki
+{
+
+/**
+ * @brief get name of a state for log-messages
+ */
+static const std::string
+getStateName(const CircuitState state)
+{
+    switch(state)
+    {
+        case CIRCUIT_CLOSED:    return "closed";
+        case CIRCUIT_OPEN:      return "open";
+        case CIRCUIT_HALF_OPEN: return "half-open";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief constructor
+ */
+CircuitBreaker::CircuitBreaker() {}
+
+/**
+ * @brief check if a request is allowed. In open state all requests are rejected, until the
+ *        open-time is over. Then a single trial-request is allowed in half-open state.
+ *
+ * @return true, if request is allowed, else false
+ */
+bool
+CircuitBreaker::allowRequest()
+{
+    CircuitState oldState = CIRCUIT_HALF_OPEN;
+    CircuitStateCallback callback;
+    bool result = false;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if(m_state == CIRCUIT_CLOSED) {
+            return true;
+        }
+
+        if(m_state == CIRCUIT_OPEN)
+        {
+            const auto openTime = std::chrono::milliseconds(m_openTimeMs);
+            if(std::chrono::steady_clock::now() - m_openSince < openTime) {
+                return false;
+            }
+
+            changeState(CIRCUIT_HALF_OPEN, oldState, callback);
+        }
+
+        // in half-open state only one trial-request is allowed at the same time
+        if(m_trialRunning == false)
+        {
+            m_trialRunning = true;
+            result = true;
+        }
+    }
+
+    notify(oldState, CIRCUIT_HALF_OPEN, callback);
+
+    return result;
+}
+
+/**
+ * @brief report a successful request, which closes the circuit again
+ */
+void
+CircuitBreaker::reportSuccess()
+{
+    CircuitState oldState = CIRCUIT_CLOSED;
+    CircuitStateCallback callback;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        m_numberOfFailures = 0;
+        m_trialRunning = false;
+        if(m_state == CIRCUIT_CLOSED) {
+            return;
+        }
+
+        changeState(CIRCUIT_CLOSED, oldState, callback);
+    }
+
+    notify(oldState, CIRCUIT_CLOSED, callback);
+}
+
+/**
+ * @brief report a failed request. The circuit is opened, if the number of failures in a row
+ *        reaches the threshold or if the trial-request in half-open state failed.
+ */
+void
+CircuitBreaker::reportFailure()
+{
+    CircuitState oldState = CIRCUIT_CLOSED;
+    CircuitStateCallback callback;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        m_numberOfFailures++;
+        m_trialRunning = false;
+        if(m_state == CIRCUIT_OPEN) {
+            return;
+        }
+        if(m_state == CIRCUIT_CLOSED
+                && m_numberOfFailures < m_failureThreshold)
+        {
+            return;
+        }
+
+        m_openSince = std::chrono::steady_clock::now();
+        changeState(CIRCUIT_OPEN, oldState, callback);
+    }
+
+    notify(oldState, CIRCUIT_OPEN, callback);
+}
+
+/**
+ * @brief get actual state of the circuit
+ */
+CircuitState
+CircuitBreaker::getState()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_state;
+}
+
+/**
+ * @brief set configuration of the breaker
+ *
+ * @param failureThreshold number of failures in a row, which opens the circuit
+ * @param openTimeMs time in milliseconds, how long the circuit stays open
+ */
+void
+CircuitBreaker::setConfig(const uint32_t failureThreshold,
+                          const uint32_t openTimeMs)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_failureThreshold = failureThreshold;
+    m_openTimeMs = openTimeMs;
+}
+
+/**
+ * @brief set callback, which is called for every state-transition
+ *
+ * @param callback new callback
+ */
+void
+CircuitBreaker::setStateCallback(const CircuitStateCallback &callback)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_stateCallback = callback;
+}
+
+/**
+ * @brief change the state. The lock must be held by the caller.
+ *
+ * @param newState new state
+ * @param oldState reference for the old state
+ * @param callback reference for the callback, which has to be called after the lock is released
+ */
+void
+CircuitBreaker::changeState(const CircuitState newState,
+                            CircuitState &oldState,
+                            CircuitStateCallback &callback)
+{
+    oldState = m_state;
+    m_state = newState;
+    callback = m_stateCallback;
+}
+
+/**
+ * @brief log a state-transition and call the callback without holding the lock
+ */
+void
+CircuitBreaker::notify(const CircuitState oldState,
+                       const CircuitState newState,
+                       const CircuitStateCallback &callback)
+{
+    if(oldState == newState) {
+        return;
+    }
+
+    LOG_WARNING("circuit-breaker for requests to misaki changed from state '"
+                + getStateName(oldState) + "' to '" + getStateName(newState) + "'");
+
+    if(callback) {
+        callback(oldState, newState);
+    }
+}
+
+}  // namespace Misaki
@@ -0,0 +1,69 @@
+/**
+ * @file        circuit_breaker.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_CIRCUIT_BREAKER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_CIRCUIT_BREAKER_H
+
+#include <mutex>
+#include <chrono>
+
+#include <libMisakiGuard/misaki_input.h>
+
+namespace Misaki
+{
+
+class CircuitBreaker
+{
+public:
+    CircuitBreaker();
+
+    bool allowRequest();
+    void reportSuccess();
+    void reportFailure();
+
+    CircuitState getState();
+    void setConfig(const uint32_t failureThreshold,
+                   const uint32_t openTimeMs);
+    void setStateCallback(const CircuitStateCallback &callback);
+
+private:
+    std::mutex m_lock;
+    CircuitState m_state = CIRCUIT_CLOSED;
+    uint32_t m_numberOfFailures = 0;
+    bool m_trialRunning = false;
+    std::chrono::steady_clock::time_point m_openSince;
+
+    uint32_t m_failureThreshold = 5;
+    uint32_t m_openTimeMs = 10000;
+    CircuitStateCallback m_stateCallback;
+
+    void changeState(const CircuitState newState,
+                     CircuitState &oldState,
+                     CircuitStateCallback &callback);
+    void notify(const CircuitState oldState,
+                const CircuitState newState,
+                const CircuitStateCallback &callback);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_CIRCUIT_BREAKER_H
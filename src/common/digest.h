@@ -0,0 +1,99 @@
+/**
+ * @file        digest.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DIGEST_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DIGEST_H
+
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+namespace Misaki
+{
+
+/**
+ * @brief calculate a fast non-cryptographic 64-bit digest of a memory-block, which works on
+ *        8 bytes per step
+ *
+ * @param data pointer to the data
+ * @param size number of bytes
+ * @param seed optional seed for the digest
+ *
+ * @return digest of the data
+ */
+inline uint64_t
+calcDigest(const void* data,
+           const uint64_t size,
+           const uint64_t seed = 0)
+{
+    const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed ^ (size * prime1);
+
+    uint64_t pos = 0;
+    for(; pos + 8 <= size; pos += 8)
+    {
+        uint64_t word = 0;
+        memcpy(&word, &bytes[pos], 8);
+        word *= prime2;
+        word = (word << 31) | (word >> 33);
+        hash ^= word * prime1;
+        hash = ((hash << 27) | (hash >> 37)) * prime1 + prime2;
+    }
+
+    // process the remaining bytes
+    uint64_t tail = 0;
+    for(uint64_t i = 0; pos + i < size; i++) {
+        tail |= static_cast<uint64_t>(bytes[pos + i]) << (8 * i);
+    }
+    hash ^= tail * prime2;
+
+    // final mix
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime1;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+/**
+ * @brief calculate a fast non-cryptographic 64-bit digest of a string
+ *
+ * @param input string to hash
+ * @param seed optional seed for the digest
+ *
+ * @return digest of the string
+ */
+inline uint64_t
+calcDigest(const std::string &input,
+           const uint64_t seed = 0)
+{
+    return calcDigest(input.c_str(), input.size(), seed);
+}
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DIGEST_H
@@ -0,0 +1,190 @@
+/**
+ * @file        misaki_call_guard.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <common/misaki_call_guard.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+MisakiCallGuard::MisakiCallGuard()
+{
+    m_circuitBreaker.setConfig(m_config.breakerFailureThreshold, m_config.breakerOpenTimeMs);
+}
+
+/**
+ * @brief get instance of the call-guard
+ *
+ * @return pointer to the static instance
+ */
+MisakiCallGuard*
+MisakiCallGuard::getInstance()
+{
+    static MisakiCallGuard instance;
+    return &instance;
+}
+
+/**
+ * @brief run a request to misaki with retries and protection by the circuit-breaker. Only
+ *        requests, where misaki was not reachable, are retried and count as failure for the
+ *        breaker. Rejections by misaki are returned directly. No new try is started and no
+ *        backoff is waited for, after the deadline was reached. A single try itself is not
+ *        interrupted by the deadline, because triggerSakuraFile of the messaging-client has no
+ *        timeout-parameter, so a try, which hangs, is only bounded by the messaging-layer.
+ *
+ * @param misakiCall function, which sends the request
+ * @param deadline point in time, after which no further try is done
+ * @param error reference for error-output
+ *
+ * @return result of the last try or MISAKI_CALL_DEADLINE_EXCEEDED, if the deadline was reached
+ *         before the request was successful
+ */
+MisakiCallResult
+MisakiCallGuard::call(const MisakiCall &misakiCall,
+                      const std::chrono::steady_clock::time_point &deadline,
+                      ErrorContainer &error)
+{
+    const MisakiCallConfig config = getConfig();
+
+    for(uint32_t attempt = 0; attempt <= config.maxRetries; attempt++)
+    {
+        if(std::chrono::steady_clock::now() >= deadline)
+        {
+            error.addMeesage("Deadline for the request to misaki reached after "
+                             + std::to_string(attempt) + " tries");
+            return MISAKI_CALL_DEADLINE_EXCEEDED;
+        }
+
+        if(m_circuitBreaker.allowRequest() == false)
+        {
+            error.addMeesage("Misaki is marked as unhealthy by the circuit-breaker");
+            return MISAKI_CALL_UNREACHABLE;
+        }
+
+        ErrorContainer attemptError;
+        const MisakiCallResult result = misakiCall(attemptError);
+        if(result != MISAKI_CALL_UNREACHABLE)
+        {
+            m_circuitBreaker.reportSuccess();
+            if(result == MISAKI_CALL_REJECTED) {
+                error = attemptError;
+            }
+            return result;
+        }
+
+        m_circuitBreaker.reportFailure();
+        if(attempt == config.maxRetries)
+        {
+            error = attemptError;
+            break;
+        }
+
+        // never sleep beyond the deadline
+        const auto backoffEnd = std::chrono::steady_clock::now()
+                                + std::chrono::milliseconds(getBackoffTime(config, attempt));
+        std::this_thread::sleep_until(std::min(backoffEnd, deadline));
+    }
+
+    error.addMeesage("Request to misaki failed after "
+                     + std::to_string(config.maxRetries + 1) + " tries");
+
+    return MISAKI_CALL_UNREACHABLE;
+}
+
+/**
+ * @brief get point in time, until a request to misaki, which starts now, may take
+ *
+ * @return actual time plus the configured deadline
+ */
+std::chrono::steady_clock::time_point
+MisakiCallGuard::getDeadline()
+{
+    const MisakiCallConfig config = getConfig();
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(config.deadlineMs);
+}
+
+/**
+ * @brief set new configuration for all requests to misaki
+ *
+ * @param config new configuration
+ */
+void
+MisakiCallGuard::setConfig(const MisakiCallConfig &config)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_config = config;
+    m_circuitBreaker.setConfig(config.breakerFailureThreshold, config.breakerOpenTimeMs);
+}
+
+/**
+ * @brief get actual configuration
+ */
+MisakiCallConfig
+MisakiCallGuard::getConfig()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_config;
+}
+
+/**
+ * @brief get circuit-breaker for the requests to misaki
+ */
+CircuitBreaker*
+MisakiCallGuard::getCircuitBreaker()
+{
+    return &m_circuitBreaker;
+}
+
+/**
+ * @brief get time to wait before the next try, which is a random value between zero and an
+ *        exponential growing upper limit, so retries of multiple threads are spread
+ *
+ * @param config actual configuration
+ * @param attempt number of the failed try
+ *
+ * @return time in milliseconds
+ */
+uint32_t
+MisakiCallGuard::getBackoffTime(const MisakiCallConfig &config,
+                                const uint32_t attempt)
+{
+    thread_local std::mt19937 generator(std::random_device{}());
+
+    uint64_t upperLimit = static_cast<uint64_t>(config.initialBackoffMs) << std::min(attempt, 20u);
+    if(upperLimit > config.maxBackoffMs) {
+        upperLimit = config.maxBackoffMs;
+    }
+
+    std::uniform_int_distribution<uint64_t> distribution(0, upperLimit);
+
+    return static_cast<uint32_t>(distribution(generator));
+}
+
+}  // namespace Misaki
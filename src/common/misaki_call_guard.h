@@ -0,0 +1,73 @@
+/**
+ * @file        misaki_call_guard.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_MISAKI_CALL_GUARD_H
+#define KITSUNEMIMI_HANAMI_MISAKI_MISAKI_CALL_GUARD_H
+
+#include <mutex>
+#include <chrono>
+#include <functional>
+
+#include <common/circuit_breaker.h>
+#include <libMisakiGuard/misaki_input.h>
+
+namespace Misaki
+{
+
+enum MisakiCallResult
+{
+    MISAKI_CALL_OK = 0,
+    MISAKI_CALL_REJECTED = 1,
+    MISAKI_CALL_UNREACHABLE = 2,
+    MISAKI_CALL_DEADLINE_EXCEEDED = 3,
+};
+
+typedef std::function<MisakiCallResult(Kitsunemimi::ErrorContainer &error)> MisakiCall;
+
+class MisakiCallGuard
+{
+public:
+    static MisakiCallGuard* getInstance();
+
+    MisakiCallResult call(const MisakiCall &misakiCall,
+                          const std::chrono::steady_clock::time_point &deadline,
+                          Kitsunemimi::ErrorContainer &error);
+    std::chrono::steady_clock::time_point getDeadline();
+
+    void setConfig(const MisakiCallConfig &config);
+    MisakiCallConfig getConfig();
+    CircuitBreaker* getCircuitBreaker();
+
+private:
+    MisakiCallGuard();
+
+    std::mutex m_lock;
+    MisakiCallConfig m_config;
+    CircuitBreaker m_circuitBreaker;
+
+    uint32_t getBackoffTime(const MisakiCallConfig &config,
+                            const uint32_t attempt);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_MISAKI_CALL_GUARD_H
@@ -0,0 +1,138 @@
+/**
+ * @file        rcu_pointer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_RCU_POINTER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_RCU_POINTER_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <stdint.h>
+
+namespace Misaki
+{
+
+/**
+ * Pointer to an immutable object, which can be replaced at any time while readers are using it.
+ *
+ * Readers never block. They only increment and decrement one of two reader-counters. A writer
+ * publishes the new object and then flips the active counter twice, each time waiting until the
+ * old counter is drained, before the old object is deleted. So all readers, which could still
+ * see the old object, are finished at this point.
+ */
+template<typename T>
+class RcuPointer
+{
+public:
+    class ReadGuard
+    {
+    public:
+        ReadGuard(const RcuPointer<T>* parent)
+            : m_parent(parent)
+        {
+            m_counterPos = m_parent->m_generation.load() & 1;
+            m_parent->m_readers[m_counterPos].counter.fetch_add(1);
+            m_object = m_parent->m_current.load();
+        }
+
+        ~ReadGuard()
+        {
+            m_parent->m_readers[m_counterPos].counter.fetch_sub(1);
+        }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard& operator=(const ReadGuard &) = delete;
+
+        const T* get() const { return m_object; }
+        const T* operator->() const { return m_object; }
+        const T& operator*() const { return *m_object; }
+
+    private:
+        const RcuPointer<T>* m_parent;
+        const T* m_object = nullptr;
+        uint32_t m_counterPos = 0;
+    };
+
+    RcuPointer(T* initial = nullptr)
+    {
+        m_current = initial;
+    }
+
+    ~RcuPointer()
+    {
+        delete m_current.load();
+    }
+
+    RcuPointer(const RcuPointer &) = delete;
+    RcuPointer& operator=(const RcuPointer &) = delete;
+
+    /**
+     * @brief get read-access to the actual object, which stays valid until the guard is destroyed
+     */
+    ReadGuard read() const
+    {
+        return ReadGuard(this);
+    }
+
+    /**
+     * @brief replace the actual object and delete the old one, after all readers are finished
+     *
+     * @param newObject new object, which is owned by the pointer afterwards
+     */
+    void publish(T* newObject)
+    {
+        std::lock_guard<std::mutex> guard(m_writeLock);
+
+        T* oldObject = m_current.exchange(newObject);
+        synchronize();
+        delete oldObject;
+    }
+
+private:
+    struct alignas(64) ReaderCounter
+    {
+        std::atomic<uint64_t> counter {0};
+    };
+
+    std::atomic<T*> m_current {nullptr};
+    mutable std::atomic<uint32_t> m_generation {0};
+    mutable ReaderCounter m_readers[2];
+    std::mutex m_writeLock;
+
+    /**
+     * @brief wait until all readers, which were started before this call, are finished
+     */
+    void synchronize()
+    {
+        for(uint32_t i = 0; i < 2; i++)
+        {
+            const uint32_t oldPos = m_generation.fetch_xor(1) & 1;
+            while(m_readers[oldPos].counter.load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_RCU_POINTER_H
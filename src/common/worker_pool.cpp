@@ -0,0 +1,200 @@
+/**
+ * @file        worker_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <common/worker_pool.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <chrono>
+#include <exception>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ *
+ * @param threadName name of the threads of the pool
+ * @param numberOfWorkers number of threads
+ * @param maxPendingTasks maximum number of tasks, which are waiting for a thread
+ */
+WorkerPool::WorkerPool(const std::string &threadName,
+                       const uint32_t numberOfWorkers,
+                       const uint32_t maxPendingTasks)
+    : m_threadName(threadName),
+      m_numberOfWorkers(numberOfWorkers),
+      m_maxPendingTasks(maxPendingTasks) {}
+
+/**
+ * @brief destructor
+ */
+WorkerPool::~WorkerPool()
+{
+    shutdown();
+}
+
+/**
+ * @brief add a new task, which is processed by the next free thread of the pool
+ *
+ * @param task task to process
+ *
+ * @return false, if the queue is full, the pool was shut down or the threads can not be
+ *         started, else true
+ */
+bool
+WorkerPool::addTask(const std::function<void()> &task)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if(m_isShutdown
+            || m_tasks.size() >= m_maxPendingTasks)
+    {
+        return false;
+    }
+
+    if(m_workers.size() == 0
+            && startWorkers() == false)
+    {
+        return false;
+    }
+
+    m_tasks.push_back(task);
+    m_taskCondition.notify_one();
+
+    return true;
+}
+
+/**
+ * @brief stop all threads of the pool and wait until the running tasks are finished. Queued
+ *        tasks, which were not started yet, are dropped and new tasks are rejected.
+ */
+void
+WorkerPool::shutdown()
+{
+    std::vector<WorkerPoolThread*> workers;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_isShutdown = true;
+        m_tasks.clear();
+        workers.swap(m_workers);
+    }
+    m_taskCondition.notify_all();
+
+    // the lock must be released here, because the threads need it to finish their loop
+    for(WorkerPoolThread* worker : workers)
+    {
+        worker->stopThread();
+        delete worker;
+    }
+}
+
+/**
+ * @brief start the threads of the pool. The lock must be held by the caller.
+ *
+ * @return false, if no thread can be started, else true
+ */
+bool
+WorkerPool::startWorkers()
+{
+    for(uint32_t i = 0; i < m_numberOfWorkers; i++)
+    {
+        WorkerPoolThread* worker = new WorkerPoolThread(m_threadName, this);
+        if(worker->startThread() == false)
+        {
+            delete worker;
+            ErrorContainer error;
+            error.addMeesage("Failed to start thread '" + m_threadName + "'");
+            LOG_ERROR(error);
+            return m_workers.size() > 0;
+        }
+        m_workers.push_back(worker);
+    }
+
+    return true;
+}
+
+/**
+ * @brief wait for the next task and process it. Exceptions of the task are logged, so they
+ *        can not terminate the process.
+ *
+ * @param timeoutMs maximum time in milliseconds to wait for a task
+ */
+void
+WorkerPool::processNextTask(const uint32_t timeoutMs)
+{
+    std::function<void()> task;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_taskCondition.wait_for(lock,
+                                 std::chrono::milliseconds(timeoutMs),
+                                 [this] { return m_tasks.size() > 0 || m_isShutdown; });
+        if(m_tasks.size() == 0) {
+            return;
+        }
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+    }
+
+    try
+    {
+        task();
+    }
+    catch(const std::exception &e)
+    {
+        ErrorContainer error;
+        error.addMeesage("Task in thread '" + m_threadName + "' failed: " + e.what());
+        LOG_ERROR(error);
+    }
+    catch(...)
+    {
+        ErrorContainer error;
+        error.addMeesage("Task in thread '" + m_threadName + "' failed with unknown exception");
+        LOG_ERROR(error);
+    }
+}
+
+/**
+ * @brief constructor
+ *
+ * @param threadName name of the thread
+ * @param pool pool, which owns the thread
+ */
+WorkerPoolThread::WorkerPoolThread(const std::string &threadName,
+                                   WorkerPool* pool)
+    : Kitsunemimi::Thread(threadName),
+      m_pool(pool) {}
+
+/**
+ * @brief loop, which processes the tasks of the pool
+ */
+void
+WorkerPoolThread::run()
+{
+    while(m_abort == false) {
+        m_pool->processNextTask(100);
+    }
+}
+
+}  // namespace Misaki
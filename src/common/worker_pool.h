@@ -0,0 +1,91 @@
+/**
+ * @file        worker_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_WORKER_POOL_H
+#define KITSUNEMIMI_HANAMI_MISAKI_WORKER_POOL_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Misaki
+{
+
+class WorkerPoolThread;
+
+/**
+ * Small fixed pool of threads with a bounded queue of tasks. The threads are started with the
+ * first task. Tasks, which don't fit into the queue, are rejected instead of piling up.
+ */
+class WorkerPool
+{
+public:
+    WorkerPool(const std::string &threadName,
+               const uint32_t numberOfWorkers,
+               const uint32_t maxPendingTasks);
+    ~WorkerPool();
+
+    bool addTask(const std::function<void()> &task);
+    void shutdown();
+
+private:
+    friend class WorkerPoolThread;
+
+    const std::string m_threadName;
+    const uint32_t m_numberOfWorkers;
+    const uint32_t m_maxPendingTasks;
+
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<WorkerPoolThread*> m_workers;
+    bool m_isShutdown = false;
+    std::mutex m_lock;
+    std::condition_variable m_taskCondition;
+
+    bool startWorkers();
+    void processNextTask(const uint32_t timeoutMs);
+};
+
+/**
+ * Thread of a worker-pool.
+ */
+class WorkerPoolThread
+        : public Kitsunemimi::Thread
+{
+public:
+    WorkerPoolThread(const std::string &threadName,
+                     WorkerPool* pool);
+
+protected:
+    void run();
+
+private:
+    WorkerPool* m_pool = nullptr;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_WORKER_POOL_H
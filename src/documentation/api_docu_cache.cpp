@@ -0,0 +1,596 @@
+/**
+ * @file        api_docu_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <documentation/api_docu_cache.h>
+#include <documentation/docu_stream.h>
+#include <documentation/docu_renderer.h>
+#include <metrics/guard_metrics.h>
+#include <common/base64.h>
+#include <common/digest.h>
+#include <permission/policy_store.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiCommon/methods/string_methods.h>
+
+#include <algorithm>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+ApiDocuCache::ApiDocuCache()
+{
+    updateRegistryVersion();
+}
+
+/**
+ * @brief get instance of the documentation-cache
+ *
+ * @return pointer to the static instance
+ */
+ApiDocuCache*
+ApiDocuCache::getInstance()
+{
+    static ApiDocuCache instance;
+    return &instance;
+}
+
+/**
+ * @brief get the documentation of the api. The document is only rendered again, if the
+ *        version of the endpoint-registry was changed since the last call. While rendering, the
+ *        document is directly written in chunks into the cached string, so there is no
+ *        additional full-size buffer. Compressed documents are created from the raw
+ *        document, which is cached too, so each compression is done only once. Filtered
+ *        documents are cached under their content-hash and compressed with the fast level,
+ *        because they are small and many different filters share the same cache. Documents,
+ *        which are restricted to roles, are cached per set of roles, so all users with the
+ *        same roles share one document.
+ *
+ * @param format format of the document
+ * @param compression compression of the document
+ * @param encodeBase64 true to get the document base64-encoded, false for the raw document
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ * @param error reference for error-output
+ *
+ * @return shared pointer to the documentation, or nullptr if the compression failed
+ */
+std::shared_ptr<const std::string>
+ApiDocuCache::getDocu(const DocuFormat format,
+                      const DocuCompression compression,
+                      const bool encodeBase64,
+                      const std::string &localComponent,
+                      const DocuFilter &filter,
+                      ErrorContainer &error)
+{
+    const RegistryState registryState = getRegistryState();
+    const uint64_t registryVersion = registryState.version;
+    const uint64_t policyVersion = getPolicyVersion(filter);
+    const std::string roleKey = filter.getRoleKey();
+    const uint64_t selectionHash = filter.hasSelection() ? getContentHash(format,
+                                                                          localComponent,
+                                                                          filter)
+                                                         : 0;
+    const CacheKey key(format, compression, encodeBase64, roleKey, selectionHash);
+
+    // the strong compression only pays off for complete documents, which stay in the cache
+    const bool preferSpeed = filter.hasSelection()
+                             || registryState.isResolved == false;
+
+    DocuCreator creator;
+    if(compression == NO_DOCU_COMPRESSION)
+    {
+        creator = [&]() {
+            return renderDocu(format, encodeBase64, localComponent, filter);
+        };
+    }
+    else
+    {
+        creator = [&]() -> std::shared_ptr<const std::string>
+        {
+            // get raw document as input for the compression
+            const CacheKey rawKey(format, NO_DOCU_COMPRESSION, false, roleKey, selectionHash);
+            bool isRawCached = false;
+            const std::shared_ptr<const std::string> rawDocu = getOrCreateDocu(
+                    isRawCached,
+                    rawKey,
+                    registryVersion,
+                    policyVersion,
+                    localComponent,
+                    [&]() { return renderDocu(format, false, localComponent, filter); });
+
+            return createCompressedDocu(*rawDocu,
+                                        compression,
+                                        encodeBase64,
+                                        preferSpeed,
+                                        error);
+        };
+    }
+
+    bool isCached = false;
+    const std::shared_ptr<const std::string> docu = getOrCreateDocu(isCached,
+                                                                    key,
+                                                                    registryVersion,
+                                                                    policyVersion,
+                                                                    localComponent,
+                                                                    creator);
+    if(isCached) {
+        GuardMetrics::increaseCounter(DOCU_CACHE_HIT_COUNTER);
+    } else {
+        GuardMetrics::increaseCounter(DOCU_CACHE_MISS_COUNTER);
+    }
+
+    if(docu == nullptr) {
+        error.addMeesage("Failed to create documentation");
+    }
+
+    return docu;
+}
+
+/**
+ * @brief get a document from the cache or create it. Only one caller creates a missing
+ *        document, while concurrent callers with the same key wait for its result instead of
+ *        rendering the same document again. The lock is not held while creating the document,
+ *        so requests for other documents are not blocked by a render.
+ *
+ * @param isCached reference, which is set to true, if the document was cached or created by
+ *                 another caller
+ * @param key format, compression, encoding, roles and selection of the document
+ * @param registryVersion actual version of the endpoint-registry
+ * @param policyVersion actual version of the policy, or 0 if not restricted to roles
+ * @param localComponent name of the local component, which is the title of the document
+ * @param creator function to create the document
+ *
+ * @return shared pointer to the document, or nullptr if the creation failed
+ */
+std::shared_ptr<const std::string>
+ApiDocuCache::getOrCreateDocu(bool &isCached,
+                              const CacheKey &key,
+                              const uint64_t registryVersion,
+                              const uint64_t policyVersion,
+                              const std::string &localComponent,
+                              const DocuCreator &creator)
+{
+    std::promise<std::shared_ptr<const std::string>> promise;
+    std::shared_ptr<PendingDocu> pending;
+    isCached = true;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        std::shared_ptr<const std::string> docu = getCachedDocu(key,
+                                                                registryVersion,
+                                                                policyVersion,
+                                                                localComponent);
+        if(docu != nullptr) {
+            return docu;
+        }
+
+        const auto it = m_pendingDocus.find(key);
+        if(it != m_pendingDocus.end()
+                && it->second->registryVersion == registryVersion
+                && it->second->policyVersion == policyVersion
+                && it->second->localComponent == localComponent)
+        {
+            pending = it->second;
+        }
+        else
+        {
+            isCached = false;
+            pending = std::make_shared<PendingDocu>();
+            pending->registryVersion = registryVersion;
+            pending->policyVersion = policyVersion;
+            pending->localComponent = localComponent;
+            pending->docu = promise.get_future().share();
+            m_pendingDocus[key] = pending;
+        }
+    }
+
+    // wait for the document, which is created by another caller
+    if(isCached) {
+        return pending->docu.get();
+    }
+
+    const std::shared_ptr<const std::string> docu = creator();
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if(docu != nullptr) {
+            storeDocu(key, registryVersion, policyVersion, localComponent, docu);
+        }
+
+        // the entry could already be replaced by a render for a newer version
+        const auto it = m_pendingDocus.find(key);
+        if(it != m_pendingDocus.end()
+                && it->second == pending)
+        {
+            m_pendingDocus.erase(it);
+        }
+    }
+
+    promise.set_value(docu);
+
+    return docu;
+}
+
+/**
+ * @brief get the hash of a document without rendering it. The hash is a digest over everything,
+ *        the document is created from: the endpoint-registry, the policy, the format, the title
+ *        and the filter. So it changes together with the document and doesn't depend on the
+ *        size of the registry or the document, because the registry-version is precalculated.
+ *
+ * @param format format of the document
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ *
+ * @return hash of the document
+ */
+uint64_t
+ApiDocuCache::getContentHash(const DocuFormat format,
+                             const std::string &localComponent,
+                             const DocuFilter &filter)
+{
+    // the policy-version is only a counter, which starts again with each restart, so the
+    // digest of the policy is used instead, because clients keep the hash
+    const uint64_t policyDigest = filter.restrictToRoles ? PolicyStore::getInstance()->getDigest()
+                                                         : 0;
+    const uint64_t values[7] = {getRegistryVersion(),
+                                policyDigest,
+                                static_cast<uint64_t>(format),
+                                filter.httpTypes,
+                                filter.offset,
+                                filter.limit,
+                                filter.restrictToRoles ? 1u : 0u};
+
+    uint64_t hash = calcDigest(values, sizeof(values));
+    hash = calcDigest(localComponent, hash);
+    hash = calcDigest(filter.endpointPrefix, hash);
+    hash = calcDigest(filter.group, hash);
+    hash = calcDigest(filter.getRoleKey(), hash);
+
+    return hash;
+}
+
+/**
+ * @brief remove all cached documents
+ */
+void
+ApiDocuCache::clear()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_entries.clear();
+    m_pendingDocus.clear();
+}
+
+/**
+ * @brief get a cached document, which belongs to the actual registry. The lock must be held by
+ *        the caller.
+ *
+ * @param key format, compression, encoding, roles and selection of the document
+ * @param registryVersion actual version of the endpoint-registry
+ * @param policyVersion actual version of the policy, or 0 if not restricted to roles
+ * @param localComponent name of the local component, which is the title of the document
+ *
+ * @return shared pointer to the document, or nullptr if there is no valid document
+ */
+std::shared_ptr<const std::string>
+ApiDocuCache::getCachedDocu(const CacheKey &key,
+                            const uint64_t registryVersion,
+                            const uint64_t policyVersion,
+                            const std::string &localComponent)
+{
+    const auto it = m_entries.find(key);
+    if(it != m_entries.end()
+            && it->second.registryVersion == registryVersion
+            && it->second.policyVersion == policyVersion
+            && it->second.localComponent == localComponent)
+    {
+        it->second.lastUse = ++m_useCounter;
+        return it->second.docu;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief store a document in the cache. The lock must be held by the caller.
+ *
+ * @param key format, compression, encoding, roles and selection of the document
+ * @param registryVersion version of the endpoint-registry, which was used for the document
+ * @param policyVersion version of the policy, or 0 if not restricted to roles
+ * @param localComponent name of the local component, which is the title of the document
+ * @param docu document to store
+ */
+void
+ApiDocuCache::storeDocu(const CacheKey &key,
+                        const uint64_t registryVersion,
+                        const uint64_t policyVersion,
+                        const std::string &localComponent,
+                        const std::shared_ptr<const std::string> &docu)
+{
+    // endpoints, whose blossom is registered later, would not be part of the document, so such
+    // a document is not cached. A document of an older registry is also not cached anymore.
+    const RegistryState registryState = getRegistryState();
+    if(registryState.isResolved == false
+            || registryState.version != registryVersion)
+    {
+        return;
+    }
+
+    // the number of role-sets and filters is not limited by the api, so the least recently
+    // used document is dropped, when the cache is full
+    if(m_entries.size() >= MAX_NUMBER_OF_ENTRIES
+            && m_entries.find(key) == m_entries.end())
+    {
+        auto oldest = m_entries.begin();
+        for(auto it = m_entries.begin(); it != m_entries.end(); it++)
+        {
+            if(it->second.lastUse < oldest->second.lastUse) {
+                oldest = it;
+            }
+        }
+        m_entries.erase(oldest);
+    }
+
+    CacheEntry entry;
+    entry.registryVersion = registryVersion;
+    entry.policyVersion = policyVersion;
+    entry.localComponent = localComponent;
+    entry.docu = docu;
+    entry.lastUse = ++m_useCounter;
+    m_entries[key] = entry;
+}
+
+/**
+ * @brief render a document
+ *
+ * @param format format of the document
+ * @param encodeBase64 true to get the document base64-encoded, false for the raw document
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ *
+ * @return shared pointer to the new document
+ */
+std::shared_ptr<const std::string>
+ApiDocuCache::renderDocu(const DocuFormat format,
+                         const bool encodeBase64,
+                         const std::string &localComponent,
+                         const DocuFilter &filter)
+{
+    ScopedLatency latency(DOCU_RENDER_LATENCY_NS);
+
+    std::string* newDocu = new std::string();
+    DocuStream stream(*newDocu, encodeBase64);
+    if(format == RST_DOCU_FORMAT) {
+        DocuRenderer<RstFormat>::render(stream, localComponent, filter);
+    } else if(format == MD_DOCU_FORMAT) {
+        DocuRenderer<MdFormat>::render(stream, localComponent, filter);
+    }
+    GuardMetrics::recordValue(DOCU_SIZE_BYTES, stream.getRawSize());
+
+    return std::shared_ptr<const std::string>(newDocu);
+}
+
+/**
+ * @brief compress a raw document and encode the result, if requested
+ *
+ * @param rawDocu raw document
+ * @param compression compression of the document
+ * @param encodeBase64 true to encode the compressed document with base64
+ * @param preferSpeed true to use the fast compression-level
+ * @param error reference for error-output
+ *
+ * @return shared pointer to the new document, or nullptr if the compression failed
+ */
+std::shared_ptr<const std::string>
+ApiDocuCache::createCompressedDocu(const std::string &rawDocu,
+                                   const DocuCompression compression,
+                                   const bool encodeBase64,
+                                   const bool preferSpeed,
+                                   ErrorContainer &error)
+{
+    std::string compressedDocu;
+    if(compressDocu(compressedDocu, rawDocu, compression, preferSpeed, error) == false)
+    {
+        error.addMeesage("Failed to compress documentation");
+        return nullptr;
+    }
+
+    if(encodeBase64 == false) {
+        return std::make_shared<const std::string>(std::move(compressedDocu));
+    }
+
+    std::string* encodedDocu = new std::string();
+    encodedDocu->reserve(((compressedDocu.size() + 2) / 3) * 4);
+    appendBase64(*encodedDocu, compressedDocu.data(), compressedDocu.size());
+
+    return std::shared_ptr<const std::string>(encodedDocu);
+}
+
+/**
+ * @brief restrict the document to the endpoints, which are accessible by the roles of the
+ *        user. Without a loaded policy the access can not be checked locally, so in this case
+ *        the document stays complete.
+ *
+ * @param filter reference to the filter of the document
+ * @param context context of the request with the claims of the token
+ */
+void
+ApiDocuCache::addRoleRestriction(DocuFilter &filter,
+                                 const DataMap &context)
+{
+    if(PolicyStore::getInstance()->isLoaded() == false
+            || context.getBoolByKey("is_admin"))
+    {
+        return;
+    }
+
+    filter.restrictToRoles = true;
+    if(context.contains("roles") == false) {
+        return;
+    }
+
+    // roles can be given as array or as comma-separated string
+    DataItem* roles = context.get("roles");
+    if(roles->isArray())
+    {
+        for(DataItem* role : roles->toArray()->array) {
+            filter.roles.push_back(role->getString());
+        }
+    }
+    else
+    {
+        splitStringByDelimiter(filter.roles, roles->getString(), ',');
+    }
+
+    // users with the same roles in another order share the same document
+    std::sort(filter.roles.begin(), filter.roles.end());
+    filter.roles.erase(std::unique(filter.roles.begin(), filter.roles.end()), filter.roles.end());
+}
+
+/**
+ * @brief convert the type of the documentation-request into the format of the document
+ *
+ * @param type requested type (pdf, rst, md)
+ *
+ * @return format of the document, which has to be rendered for the type
+ */
+DocuFormat
+ApiDocuCache::getDocuFormat(const std::string &type)
+{
+    if(type == "rst"
+            || type == "pdf")
+    {
+        return RST_DOCU_FORMAT;
+    }
+    else if(type == "md")
+    {
+        return MD_DOCU_FORMAT;
+    }
+
+    return UNKNOWN_DOCU_FORMAT;
+}
+
+/**
+ * @brief convert the digest of a document into the string, which is used by the api
+ *
+ * @param hash digest of the document
+ *
+ * @return digest as 16 hex-characters
+ */
+const std::string
+ApiDocuCache::convertHashToString(const uint64_t hash)
+{
+    static const char hexChars[] = "0123456789abcdef";
+
+    std::string result(16, '0');
+    for(uint32_t i = 0; i < 16; i++) {
+        result[15 - i] = hexChars[(hash >> (4 * i)) & 0xF];
+    }
+
+    return result;
+}
+
+/**
+ * @brief get version of the policy, which belongs to a document
+ *
+ * @param filter filter of the document
+ *
+ * @return version of the policy, or 0 if the document is not restricted to roles
+ */
+uint64_t
+ApiDocuCache::getPolicyVersion(const DocuFilter &filter)
+{
+    if(filter.restrictToRoles == false) {
+        return 0;
+    }
+
+    return PolicyStore::getInstance()->getVersion();
+}
+
+/**
+ * @brief calculate the version of the endpoint-registry again. The version is a digest over
+ *        path, type, group and name of all endpoint-entries and whether their blossom is
+ *        already registered, so it also changes, if an endpoint is replaced by another one,
+ *        while the number of entries stays the same. The registry is walked only here, so it
+ *        must be called after endpoints or blossoms were added.
+ */
+void
+ApiDocuCache::updateRegistryVersion()
+{
+    // concurrent updates are serialized, so an older walk can not replace a newer one
+    std::lock_guard<std::mutex> guard(m_registryLock);
+
+    HanamiMessaging* interface = HanamiMessaging::getInstance();
+    RegistryState* newState = new RegistryState();
+    newState->isResolved = true;
+
+    for(const auto& [endpoint, rules] : interface->endpointRules)
+    {
+        newState->version = calcDigest(endpoint, newState->version);
+        for(const auto& [httpType, entry] : rules)
+        {
+            const bool isResolved = interface->getBlossom(entry.group, entry.name) != nullptr;
+            const uint64_t types[3] = {static_cast<uint64_t>(httpType),
+                                       static_cast<uint64_t>(entry.type),
+                                       isResolved ? 1u : 0u};
+            newState->version = calcDigest(types, sizeof(types), newState->version);
+            newState->version = calcDigest(entry.group, newState->version);
+            newState->version = calcDigest(entry.name, newState->version);
+            newState->isResolved = newState->isResolved && isResolved;
+        }
+    }
+
+    m_registryState.publish(newState);
+}
+
+/**
+ * @brief get version of the endpoint-registry, which was calculated by the last update
+ *
+ * @return digest of the registered endpoint-entries
+ */
+uint64_t
+ApiDocuCache::getRegistryVersion() const
+{
+    return getRegistryState().version;
+}
+
+/**
+ * @brief get copy of the state of the endpoint-registry, so the read-guard is not held while
+ *        rendering
+ *
+ * @return version of the registry and whether the blossoms of all endpoints are registered
+ */
+ApiDocuCache::RegistryState
+ApiDocuCache::getRegistryState() const
+{
+    const RcuPointer<RegistryState>::ReadGuard registryState = m_registryState.read();
+    return *registryState;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,145 @@
+/**
+ * @file        api_docu_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_API_DOCU_CACHE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_API_DOCU_CACHE_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <tuple>
+#include <future>
+#include <functional>
+
+#include <documentation/docu_compression.h>
+#include <documentation/docu_filter.h>
+#include <common/rcu_pointer.h>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+
+namespace Misaki
+{
+
+enum DocuFormat
+{
+    UNKNOWN_DOCU_FORMAT = 0,
+    RST_DOCU_FORMAT = 1,
+    MD_DOCU_FORMAT = 2,
+};
+
+class ApiDocuCache
+{
+public:
+    static ApiDocuCache* getInstance();
+
+    std::shared_ptr<const std::string> getDocu(const DocuFormat format,
+                                               const DocuCompression compression,
+                                               const bool encodeBase64,
+                                               const std::string &localComponent,
+                                               const DocuFilter &filter,
+                                               Kitsunemimi::ErrorContainer &error);
+    uint64_t getContentHash(const DocuFormat format,
+                            const std::string &localComponent,
+                            const DocuFilter &filter);
+    void clear();
+    void updateRegistryVersion();
+    uint64_t getRegistryVersion() const;
+
+    static const uint32_t MAX_NUMBER_OF_ENTRIES = 256;
+
+    static void addRoleRestriction(DocuFilter &filter,
+                                   const Kitsunemimi::DataMap &context);
+    static DocuFormat getDocuFormat(const std::string &type);
+    static const std::string convertHashToString(const uint64_t hash);
+
+private:
+    ApiDocuCache();
+
+    struct CacheEntry
+    {
+        uint64_t registryVersion = 0;
+        uint64_t policyVersion = 0;
+        std::string localComponent = "";
+        std::shared_ptr<const std::string> docu;
+        uint64_t lastUse = 0;
+    };
+
+    struct PendingDocu
+    {
+        uint64_t registryVersion = 0;
+        uint64_t policyVersion = 0;
+        std::string localComponent = "";
+        std::shared_future<std::shared_ptr<const std::string>> docu;
+    };
+
+    struct RegistryState
+    {
+        uint64_t version = 0;
+        bool isResolved = false;
+    };
+
+    // the last value is the content-hash for filtered documents and 0 for complete documents
+    typedef std::tuple<DocuFormat, DocuCompression, bool, std::string, uint64_t> CacheKey;
+    typedef std::function<std::shared_ptr<const std::string>()> DocuCreator;
+
+    std::map<CacheKey, CacheEntry> m_entries;
+    uint64_t m_useCounter = 0;
+    std::map<CacheKey, std::shared_ptr<PendingDocu>> m_pendingDocus;
+    std::mutex m_lock;
+    RcuPointer<RegistryState> m_registryState;
+    std::mutex m_registryLock;
+
+    std::shared_ptr<const std::string> getOrCreateDocu(bool &isCached,
+                                                       const CacheKey &key,
+                                                       const uint64_t registryVersion,
+                                                       const uint64_t policyVersion,
+                                                       const std::string &localComponent,
+                                                       const DocuCreator &creator);
+    std::shared_ptr<const std::string> getCachedDocu(const CacheKey &key,
+                                                     const uint64_t registryVersion,
+                                                     const uint64_t policyVersion,
+                                                     const std::string &localComponent);
+    void storeDocu(const CacheKey &key,
+                   const uint64_t registryVersion,
+                   const uint64_t policyVersion,
+                   const std::string &localComponent,
+                   const std::shared_ptr<const std::string> &docu);
+    static std::shared_ptr<const std::string> renderDocu(const DocuFormat format,
+                                                         const bool encodeBase64,
+                                                         const std::string &localComponent,
+                                                         const DocuFilter &filter);
+    static std::shared_ptr<const std::string> createCompressedDocu(
+            const std::string &rawDocu,
+            const DocuCompression compression,
+            const bool encodeBase64,
+            const bool preferSpeed,
+            Kitsunemimi::ErrorContainer &error);
+
+    static uint64_t getPolicyVersion(const DocuFilter &filter);
+    RegistryState getRegistryState() const;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_API_DOCU_CACHE_H
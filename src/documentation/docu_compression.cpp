@@ -0,0 +1,187 @@
+/**
+ * @file        docu_compression.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <documentation/docu_compression.h>
+
+#include <zlib.h>
+#include <zstd.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * The complete documents are cached, so they are compressed only once per change of the
+ * endpoint-registry. Because of this their levels are chosen for size and not for speed.
+ * Filtered documents are small and rarely requested twice, so they use the fast levels.
+ */
+static const int GZIP_LEVEL = Z_BEST_COMPRESSION;
+static const int ZSTD_LEVEL = 12;
+static const int GZIP_FAST_LEVEL = Z_BEST_SPEED;
+static const int ZSTD_FAST_LEVEL = 1;
+
+/**
+ * @brief compress a document in gzip-format
+ *
+ * @param output reference for the compressed document
+ * @param input document to compress
+ * @param level compression-level
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+static bool
+compressGzip(std::string &output,
+             const std::string &input,
+             const int level,
+             ErrorContainer &error)
+{
+    z_stream stream = {};
+
+    // 16 added to the window-bits creates a gzip-header instead of a zlib-header
+    if(deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        error.addMeesage("Failed to initialize gzip-compression");
+        return false;
+    }
+
+    output.resize(deflateBound(&stream, input.size()));
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    const int ret = deflate(&stream, Z_FINISH);
+    const uint64_t compressedSize = stream.total_out;
+    deflateEnd(&stream);
+
+    if(ret != Z_STREAM_END)
+    {
+        error.addMeesage("Failed to compress documentation with gzip");
+        return false;
+    }
+
+    output.resize(compressedSize);
+
+    return true;
+}
+
+/**
+ * @brief compress a document in zstd-format
+ *
+ * @param output reference for the compressed document
+ * @param input document to compress
+ * @param level compression-level
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+static bool
+compressZstd(std::string &output,
+             const std::string &input,
+             const int level,
+             ErrorContainer &error)
+{
+    output.resize(ZSTD_compressBound(input.size()));
+
+    const size_t ret = ZSTD_compress(&output[0],
+                                     output.size(),
+                                     input.data(),
+                                     input.size(),
+                                     level);
+    if(ZSTD_isError(ret))
+    {
+        error.addMeesage("Failed to compress documentation with zstd: "
+                         + std::string(ZSTD_getErrorName(ret)));
+        return false;
+    }
+
+    output.resize(ret);
+
+    return true;
+}
+
+/**
+ * @brief convert the name of a compression into its type
+ *
+ * @param name name of the compression (none, gzip, zstd)
+ *
+ * @return type of the compression
+ */
+DocuCompression
+getDocuCompression(const std::string &name)
+{
+    if(name == "none") {
+        return NO_DOCU_COMPRESSION;
+    } else if(name == "gzip") {
+        return GZIP_DOCU_COMPRESSION;
+    } else if(name == "zstd") {
+        return ZSTD_DOCU_COMPRESSION;
+    }
+
+    return UNKNOWN_DOCU_COMPRESSION;
+}
+
+/**
+ * @brief compress a rendered document
+ *
+ * @param output reference for the compressed document
+ * @param input document to compress
+ * @param compression type of the compression
+ * @param preferSpeed true to use the fast level for documents, which are not kept for long
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+compressDocu(std::string &output,
+             const std::string &input,
+             const DocuCompression compression,
+             const bool preferSpeed,
+             ErrorContainer &error)
+{
+    switch(compression)
+    {
+        case NO_DOCU_COMPRESSION:
+            output = input;
+            return true;
+        case GZIP_DOCU_COMPRESSION:
+            return compressGzip(output,
+                                input,
+                                preferSpeed ? GZIP_FAST_LEVEL : GZIP_LEVEL,
+                                error);
+        case ZSTD_DOCU_COMPRESSION:
+            return compressZstd(output,
+                                input,
+                                preferSpeed ? ZSTD_FAST_LEVEL : ZSTD_LEVEL,
+                                error);
+        default:
+            break;
+    }
+
+    error.addMeesage("Unknown compression of the documentation");
+    return false;
+}
+
+}  // namespace Misaki
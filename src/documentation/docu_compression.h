@@ -0,0 +1,51 @@
+/**
+ * @file        docu_compression.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_COMPRESSION_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_COMPRESSION_H
+
+#include <string>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Misaki
+{
+
+enum DocuCompression
+{
+    UNKNOWN_DOCU_COMPRESSION = 0,
+    NO_DOCU_COMPRESSION = 1,
+    GZIP_DOCU_COMPRESSION = 2,
+    ZSTD_DOCU_COMPRESSION = 3,
+};
+
+DocuCompression getDocuCompression(const std::string &name);
+
+bool compressDocu(std::string &output,
+                  const std::string &input,
+                  const DocuCompression compression,
+                  const bool preferSpeed,
+                  Kitsunemimi::ErrorContainer &error);
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_COMPRESSION_H
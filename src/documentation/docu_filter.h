@@ -0,0 +1,115 @@
+/**
+ * @file        docu_filter.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_FILTER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_FILTER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+namespace Misaki
+{
+
+/**
+ * Selection of the endpoints, which are part of a document. The default-filter selects all.
+ * Only the endpoints within the range of the prefix are visited, so the costs of a filtered
+ * document depend on the size of this range and not on the size of the whole api.
+ *
+ * Independent of the selection, the document can be restricted to the endpoints, which are
+ * accessible by a set of roles. The roles are checked against the policy, which is actual
+ * while rendering.
+ */
+struct DocuFilter
+{
+    std::string endpointPrefix = "";
+    std::string group = "";
+    // bit-mask of the http-types with (1 << type), 0 to select all types
+    uint32_t httpTypes = 0;
+    uint64_t offset = 0;
+    // maximum number of endpoints, 0 for no limit
+    uint64_t limit = 0;
+
+    // sorted list of unique roles, which is only used, if restricted
+    bool restrictToRoles = false;
+    std::vector<std::string> roles;
+
+    bool hasSelection() const
+    {
+        return endpointPrefix.size() > 0
+               || group.size() > 0
+               || httpTypes != 0
+               || offset != 0
+               || limit != 0;
+    }
+
+    std::string getRoleKey() const
+    {
+        if(restrictToRoles == false) {
+            return "";
+        }
+
+        std::string roleKey = "roles:";
+        for(const std::string &role : roles)
+        {
+            roleKey.append(role);
+            roleKey.push_back(',');
+        }
+
+        return roleKey;
+    }
+
+    bool matchPrefix(const std::string &endpoint) const
+    {
+        return endpoint.compare(0, endpointPrefix.size(), endpointPrefix) == 0;
+    }
+
+    bool matchRule(const Kitsunemimi::Hanami::HttpRequestType httpType,
+                   const Kitsunemimi::Hanami::EndpointEntry &entry) const
+    {
+        if(httpTypes != 0
+                && (httpTypes & (1u << httpType)) == 0)
+        {
+            return false;
+        }
+
+        return group.size() == 0
+               || entry.group == group;
+    }
+
+    bool operator==(const DocuFilter &other) const
+    {
+        return endpointPrefix == other.endpointPrefix
+               && group == other.group
+               && httpTypes == other.httpTypes
+               && offset == other.offset
+               && limit == other.limit
+               && restrictToRoles == other.restrictToRoles
+               && roles == other.roles;
+    }
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_FILTER_H
@@ -0,0 +1,173 @@
+/**
+ * @file        docu_formats.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_FORMATS_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_FORMATS_H
+
+#include <string>
+#include <string_view>
+
+#include <libKitsunemimiCommon/methods/string_methods.h>
+
+namespace Misaki
+{
+
+/**
+ * Output-formats of the api-documentation. Each format only defines how the single elements of
+ * the document look like. The walk over the registry is done by the DocuRenderer, which is
+ * instantiated once per format in docu_renderer.cpp. The sink is either the size-calculation
+ * or the real output, so a format must write exactly the same in both cases.
+ */
+
+//==================================================================================================
+// reStructuredText
+//==================================================================================================
+struct RstFormat
+{
+    template<typename SINK>
+    static void title(SINK &sink, const std::string &localComponent)
+    {
+        std::string upperTitle = localComponent;
+        Kitsunemimi::toUpperCase(upperTitle);
+        sink.append(upperTitle);
+        sink.append("\n");
+        sink.append(localComponent.size(), '=');
+        sink.append("\n\n");
+    }
+
+    template<typename SINK>
+    static void endpoint(SINK &sink, const std::string &endpoint)
+    {
+        sink.append(endpoint);
+        sink.append("\n");
+        sink.append(endpoint.size(), '-');
+        sink.append("\n");
+    }
+
+    template<typename SINK>
+    static void httpType(SINK &sink, const std::string_view httpType)
+    {
+        sink.append("\n");
+        sink.append(httpType);
+        sink.append("\n");
+        sink.append(httpType.size(), '^');
+        sink.append("\n\n");
+    }
+
+    template<typename SINK>
+    static void section(SINK &sink, const std::string_view name)
+    {
+        sink.append("\n");
+        sink.append(name);
+        sink.append("\n");
+        sink.append(name.size(), '~');
+        sink.append("\n");
+    }
+
+    template<typename SINK>
+    static void field(SINK &sink, const std::string &name, const std::string &comment)
+    {
+        sink.append("\n``");
+        sink.append(name);
+        sink.append("``\n");
+        if(comment.size() > 0) {
+            attribute(sink, "Description", comment);
+        }
+    }
+
+    template<typename SINK>
+    static void attribute(SINK &sink, const std::string_view label, const std::string_view value)
+    {
+        sink.append("    **");
+        sink.append(label);
+        sink.append(":**\n        ``");
+        sink.append(value);
+        sink.append("``\n");
+    }
+};
+
+//==================================================================================================
+// Markdown
+//==================================================================================================
+struct MdFormat
+{
+    template<typename SINK>
+    static void title(SINK &sink, const std::string &localComponent)
+    {
+        sink.append("## ");
+        sink.append(localComponent);
+        sink.append("\n\n");
+    }
+
+    template<typename SINK>
+    static void endpoint(SINK &sink, const std::string &endpoint)
+    {
+        sink.append("\n### ");
+        sink.append(endpoint);
+        sink.append("\n");
+    }
+
+    template<typename SINK>
+    static void httpType(SINK &sink, const std::string_view httpType)
+    {
+        sink.append("\n#### ");
+        sink.append(httpType);
+        sink.append("\n\n");
+    }
+
+    template<typename SINK>
+    static void section(SINK &sink, const std::string_view name)
+    {
+        sink.append("\n**");
+        sink.append(name);
+        sink.append("**\n\n");
+    }
+
+    template<typename SINK>
+    static void field(SINK &sink, const std::string &name, const std::string &comment)
+    {
+        sink.append("\n`");
+        sink.append(name);
+        sink.append("`\n\n");
+        if(comment.size() > 0)
+        {
+            sink.append("**Description:** ");
+            sink.append(comment);
+            sink.append("\n\n");
+        }
+        sink.append("| attribute | value |\n| --- | --- |\n");
+    }
+
+    template<typename SINK>
+    static void attribute(SINK &sink, const std::string_view label, const std::string_view value)
+    {
+        sink.append("| *");
+        sink.append(label);
+        sink.append("* | ");
+        sink.append(value);
+        sink.append(" |\n");
+    }
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_FORMATS_H
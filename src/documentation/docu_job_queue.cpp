@@ -0,0 +1,356 @@
+/**
+ * @file        docu_job_queue.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <documentation/docu_job_queue.h>
+#include <metrics/guard_metrics.h>
+#include <token/jwt_helper.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <openssl/rand.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+DocuJobQueue::DocuJobQueue()
+    : m_workers("Misaki_DocuJobWorker", NUMBER_OF_WORKERS, MAX_PENDING_JOBS) {}
+
+/**
+ * @brief destructor, which stops the workers before the jobs and the lock, they are using,
+ *        are destroyed
+ */
+DocuJobQueue::~DocuJobQueue()
+{
+    shutdown();
+}
+
+/**
+ * @brief get instance of the documentation-job-queue
+ *
+ * @return pointer to the static instance
+ */
+DocuJobQueue*
+DocuJobQueue::getInstance()
+{
+    static DocuJobQueue instance;
+    return &instance;
+}
+
+/**
+ * @brief add a new job to render a documentation in the background. If an equal job is still
+ *        queued or running, the id of this job is returned instead.
+ *
+ * @param jobId reference for the id of the job
+ * @param format format of the document
+ * @param compression compression of the document
+ * @param encodeBase64 true to get the document base64-encoded
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ *
+ * @return false, if the queue is full, the workers can not be started or no job-id can be
+ *         created, else true
+ */
+bool
+DocuJobQueue::addJob(std::string &jobId,
+                     const DocuFormat format,
+                     const DocuCompression compression,
+                     const bool encodeBase64,
+                     const std::string &localComponent,
+                     const DocuFilter &filter)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if(m_isShutdown) {
+        return false;
+    }
+
+    removeOldJobs(getCurrentUnixTime());
+
+    // share unfinished job with the same document
+    for(const auto& [id, job] : m_jobs)
+    {
+        if(isDone(job) == false
+                && job.format == format
+                && job.compression == compression
+                && job.encodeBase64 == encodeBase64
+                && job.localComponent == localComponent
+                && job.filter == filter)
+        {
+            jobId = id;
+            return true;
+        }
+    }
+
+    DocuJob job;
+    if(createJobId(job.id) == false) {
+        return false;
+    }
+    job.format = format;
+    job.compression = compression;
+    job.encodeBase64 = encodeBase64;
+    job.localComponent = localComponent;
+    job.filter = filter;
+    job.roleKey = filter.getRoleKey();
+    job.state = QUEUED_DOCU_JOB_STATE;
+    m_jobs.emplace(job.id, job);
+
+    const std::string newJobId = job.id;
+    if(m_workers.addTask([this, newJobId]() { processJob(newJobId); }) == false)
+    {
+        m_jobs.erase(newJobId);
+        GuardMetrics::increaseCounter(DOCU_JOB_REJECTED_COUNTER);
+        return false;
+    }
+
+    GuardMetrics::increaseCounter(DOCU_JOB_COUNTER);
+    jobId = job.id;
+
+    return true;
+}
+
+/**
+ * @brief get state of a job and the document, if the job is finished
+ *
+ * @param jobId id of the job
+ * @param roleKey role-key of the filter of the caller
+ *
+ * @return status of the job with unknown state, if there is no job with the id or the job was
+ *         created for other roles
+ */
+DocuJobStatus
+DocuJobQueue::getJobStatus(const std::string &jobId,
+                           const std::string &roleKey)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    DocuJobStatus status;
+
+    const auto it = m_jobs.find(jobId);
+    if(it == m_jobs.end()
+            || it->second.roleKey != roleKey)
+    {
+        return status;
+    }
+
+    status.state = it->second.state;
+    status.docu = it->second.docu;
+
+    return status;
+}
+
+/**
+ * @brief stop all workers and wait until they are finished. Queued jobs are marked as failed
+ *        and new jobs are rejected afterwards. A job, which is actually rendered, is finished
+ *        before its worker stops.
+ */
+void
+DocuJobQueue::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_isShutdown = true;
+    }
+
+    // the running jobs need the lock to store their result, so it must not be held here
+    m_workers.shutdown();
+
+    // queued jobs were dropped by the worker-pool
+    std::lock_guard<std::mutex> guard(m_lock);
+    const long now = getCurrentUnixTime();
+    for(auto& [id, job] : m_jobs)
+    {
+        if(job.state == QUEUED_DOCU_JOB_STATE)
+        {
+            job.state = FAILED_DOCU_JOB_STATE;
+            job.finishTime = now;
+        }
+    }
+}
+
+/**
+ * @brief get name of a job-state for the output of the api
+ *
+ * @param state state of the job
+ *
+ * @return name of the state
+ */
+const std::string
+DocuJobQueue::getStateName(const DocuJobState state)
+{
+    switch(state)
+    {
+        case QUEUED_DOCU_JOB_STATE:   return "queued";
+        case RUNNING_DOCU_JOB_STATE:  return "running";
+        case FINISHED_DOCU_JOB_STATE: return "finished";
+        case FAILED_DOCU_JOB_STATE:   return "failed";
+        default:                      return "unknown";
+    }
+}
+
+/**
+ * @brief create a new random id for a job. The id is the only secret to fetch the document, so it
+ *        is taken from the cryptographic random-generator of openssl.
+ *
+ * @param jobId reference for the id with 32 hex-characters
+ *
+ * @return false, if openssl has not enough entropy, else true
+ */
+bool
+DocuJobQueue::createJobId(std::string &jobId)
+{
+    static const char hexChars[] = "0123456789abcdef";
+
+    uint8_t randomBytes[16];
+    if(RAND_bytes(randomBytes, sizeof(randomBytes)) != 1)
+    {
+        ErrorContainer error;
+        error.addMeesage("Failed to create random id for documentation-job");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    jobId.clear();
+    jobId.reserve(32);
+    for(const uint8_t byte : randomBytes)
+    {
+        jobId.push_back(hexChars[byte >> 4]);
+        jobId.push_back(hexChars[byte & 0xF]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief remove finished or failed jobs, which are expired or above the limit of finished jobs. The lock
+ *        must be held by the caller.
+ *
+ * @param now actual time in seconds since epoch
+ */
+void
+DocuJobQueue::removeOldJobs(const long now)
+{
+    uint32_t numberOfDoneJobs = 0;
+
+    auto it = m_jobs.begin();
+    while(it != m_jobs.end())
+    {
+        if(isDone(it->second) == false)
+        {
+            it++;
+            continue;
+        }
+
+        if(it->second.finishTime + FINISHED_JOB_LIFETIME < now)
+        {
+            it = m_jobs.erase(it);
+            continue;
+        }
+
+        numberOfDoneJobs++;
+        it++;
+    }
+
+    // drop the oldest done jobs, so the memory of the documents is bounded
+    while(numberOfDoneJobs > MAX_FINISHED_JOBS)
+    {
+        auto oldest = m_jobs.end();
+        for(it = m_jobs.begin(); it != m_jobs.end(); it++)
+        {
+            if(isDone(it->second)
+                    && (oldest == m_jobs.end()
+                        || it->second.finishTime < oldest->second.finishTime))
+            {
+                oldest = it;
+            }
+        }
+
+        m_jobs.erase(oldest);
+        numberOfDoneJobs--;
+    }
+}
+
+/**
+ * @brief check if a job is done, so it can be removed
+ *
+ * @param job job to check
+ *
+ * @return true, if the job is finished or failed, else false
+ */
+bool
+DocuJobQueue::isDone(const DocuJob &job)
+{
+    return job.state == FINISHED_DOCU_JOB_STATE
+           || job.state == FAILED_DOCU_JOB_STATE;
+}
+
+/**
+ * @brief render the document of a job. Called by a thread of the worker-pool.
+ *
+ * @param jobId id of the job
+ */
+void
+DocuJobQueue::processJob(const std::string &jobId)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    // unfinished jobs are never removed, so the entry stays valid while rendering
+    const auto it = m_jobs.find(jobId);
+    if(it == m_jobs.end()
+            || it->second.state != QUEUED_DOCU_JOB_STATE)
+    {
+        return;
+    }
+    DocuJob &job = it->second;
+    job.state = RUNNING_DOCU_JOB_STATE;
+    const DocuFormat format = job.format;
+    const DocuCompression compression = job.compression;
+    const bool encodeBase64 = job.encodeBase64;
+    const std::string localComponent = job.localComponent;
+    const DocuFilter filter = job.filter;
+
+    lock.unlock();
+    ErrorContainer error;
+    std::shared_ptr<const std::string> docu =
+            ApiDocuCache::getInstance()->getDocu(format,
+                                                 compression,
+                                                 encodeBase64,
+                                                 localComponent,
+                                                 filter,
+                                                 error);
+    if(docu == nullptr)
+    {
+        error.addMeesage("Failed to process documentation-job '" + jobId + "'");
+        LOG_ERROR(error);
+    }
+    lock.lock();
+
+    job.docu = docu;
+    job.state = docu != nullptr ? FINISHED_DOCU_JOB_STATE : FAILED_DOCU_JOB_STATE;
+    job.finishTime = getCurrentUnixTime();
+}
+
+}  // namespace Misaki
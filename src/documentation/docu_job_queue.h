@@ -0,0 +1,113 @@
+/**
+ * @file        docu_job_queue.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_JOB_QUEUE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_JOB_QUEUE_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <memory>
+
+#include <documentation/api_docu_cache.h>
+#include <common/worker_pool.h>
+
+namespace Misaki
+{
+
+enum DocuJobState
+{
+    UNKNOWN_DOCU_JOB_STATE = 0,
+    QUEUED_DOCU_JOB_STATE = 1,
+    RUNNING_DOCU_JOB_STATE = 2,
+    FINISHED_DOCU_JOB_STATE = 3,
+    FAILED_DOCU_JOB_STATE = 4,
+};
+
+struct DocuJobStatus
+{
+    DocuJobState state = UNKNOWN_DOCU_JOB_STATE;
+    std::shared_ptr<const std::string> docu;
+};
+
+/**
+ * Queue for documents, which are too expensive to render on the thread of the request. The jobs
+ * are rendered by a small worker-pool. The queue of the pool is bounded, so a flood of requests
+ * is rejected instead of piling up. Equal jobs, which are not finished yet, are shared.
+ * Finished jobs are kept for a limited time, until they are fetched by their job-id. A job can
+ * only be fetched with the same roles, which were used to create it.
+ */
+class DocuJobQueue
+{
+public:
+    static DocuJobQueue* getInstance();
+
+    static const uint32_t NUMBER_OF_WORKERS = 2;
+    static const uint32_t MAX_PENDING_JOBS = 16;
+    static const uint32_t MAX_FINISHED_JOBS = 64;
+    static const long FINISHED_JOB_LIFETIME = 300;
+
+    bool addJob(std::string &jobId,
+                const DocuFormat format,
+                const DocuCompression compression,
+                const bool encodeBase64,
+                const std::string &localComponent,
+                const DocuFilter &filter);
+    DocuJobStatus getJobStatus(const std::string &jobId,
+                               const std::string &roleKey);
+    void shutdown();
+
+    static const std::string getStateName(const DocuJobState state);
+
+private:
+    DocuJobQueue();
+    ~DocuJobQueue();
+
+    struct DocuJob
+    {
+        std::string id = "";
+        DocuFormat format = UNKNOWN_DOCU_FORMAT;
+        DocuCompression compression = NO_DOCU_COMPRESSION;
+        bool encodeBase64 = true;
+        std::string localComponent = "";
+        DocuFilter filter;
+        // roles of the creator, because the document is restricted to these roles
+        std::string roleKey = "";
+        DocuJobState state = UNKNOWN_DOCU_JOB_STATE;
+        std::shared_ptr<const std::string> docu;
+        long finishTime = 0;
+    };
+
+    std::map<std::string, DocuJob> m_jobs;
+    bool m_isShutdown = false;
+    std::mutex m_lock;
+    WorkerPool m_workers;
+
+    static bool createJobId(std::string &jobId);
+    void removeOldJobs(const long now);
+    static bool isDone(const DocuJob &job);
+    void processJob(const std::string &jobId);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_JOB_QUEUE_H
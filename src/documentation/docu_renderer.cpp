@@ -0,0 +1,331 @@
+/**
+ * @file        docu_renderer.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <documentation/docu_renderer.h>
+#include <permission/policy_store.h>
+
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+
+#include <charconv>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * @brief get name of a field-type for the documentation
+ *
+ * @param fieldType type of the field
+ *
+ * @return name of the type, or empty string for an undefined type
+ */
+static std::string_view
+getFieldTypeName(const Hanami::FieldType fieldType)
+{
+    switch(fieldType)
+    {
+        case Hanami::SAKURA_MAP_TYPE:    return "Map";
+        case Hanami::SAKURA_ARRAY_TYPE:  return "Array";
+        case Hanami::SAKURA_BOOL_TYPE:   return "Bool";
+        case Hanami::SAKURA_INT_TYPE:    return "Int";
+        case Hanami::SAKURA_FLOAT_TYPE:  return "Float";
+        case Hanami::SAKURA_STRING_TYPE: return "String";
+        default:                         return "";
+    }
+}
+
+/**
+ * @brief get name of a http-type for the documentation
+ *
+ * @param httpType http-type of the endpoint
+ *
+ * @return name of the type, or empty string for a not documented type
+ */
+static std::string_view
+getHttpTypeName(const Hanami::HttpRequestType httpType)
+{
+    switch(httpType)
+    {
+        case Hanami::GET_TYPE:    return "GET";
+        case Hanami::POST_TYPE:   return "POST";
+        case Hanami::DELETE_TYPE: return "DELETE";
+        case Hanami::PUT_TYPE:    return "PUT";
+        default:                  return "";
+    }
+}
+
+/**
+ * @brief calculate the size of the documentation without rendering it
+ *
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ *
+ * @return number of bytes of the document
+ */
+template<typename FORMAT>
+uint64_t
+DocuRenderer<FORMAT>::calcSize(const std::string &localComponent,
+                               const DocuFilter &filter)
+{
+    DocuSizeSink sink;
+    renderDocu(sink, localComponent, filter, []() {});
+
+    return sink.size;
+}
+
+/**
+ * @brief render the complete documentation into a string
+ *
+ * @param docu reference for the document, where the documentation is appended
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ */
+template<typename FORMAT>
+void
+DocuRenderer<FORMAT>::render(std::string &docu,
+                             const std::string &localComponent,
+                             const DocuFilter &filter)
+{
+    docu.reserve(docu.size() + calcSize(localComponent, filter));
+
+    DocuStringSink sink{docu};
+    renderDocu(sink, localComponent, filter, []() {});
+}
+
+/**
+ * @brief render the documentation endpoint by endpoint into a stream
+ *
+ * @param stream target of the document
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ */
+template<typename FORMAT>
+void
+DocuRenderer<FORMAT>::render(DocuStream &stream,
+                             const std::string &localComponent,
+                             const DocuFilter &filter)
+{
+    stream.reserveOutput(calcSize(localComponent, filter));
+
+    DocuStringSink sink{stream.getBuffer()};
+    renderDocu(sink, localComponent, filter, [&stream]() { stream.flush(); });
+
+    stream.finish();
+}
+
+/**
+ * @brief render the title and all endpoints, which match the filter. The endpoints are taken
+ *        from the range of the prefix in the ordered registry, so endpoints outside of this
+ *        range are never visited. If the document is restricted to roles, the policy is held
+ *        for the whole walk, so an update of the policy doesn't change it while rendering.
+ *
+ * @param sink target of the output
+ * @param localComponent name of the local component, which is the title of the document
+ * @param filter selection of the endpoints
+ * @param afterEndpoint function, which is called after each rendered endpoint
+ */
+template<typename FORMAT>
+template<typename SINK, typename FUNC>
+void
+DocuRenderer<FORMAT>::renderDocu(SINK &sink,
+                                 const std::string &localComponent,
+                                 const DocuFilter &filter,
+                                 FUNC afterEndpoint)
+{
+    HanamiMessaging* langInterface = HanamiMessaging::getInstance();
+    const auto &endpointRules = langInterface->endpointRules;
+
+    // without policy a restricted document contains no endpoints
+    const RcuPointer<PolicyIndex>::ReadGuard policy = PolicyStore::getInstance()->readIndex();
+    DocuSelection selection(filter);
+    if(filter.restrictToRoles
+            && policy.get() != nullptr)
+    {
+        selection.policy = policy.get();
+        selection.policy->getRoleMask(selection.roleMask, filter.roles);
+    }
+
+    FORMAT::title(sink, localComponent);
+
+    uint64_t numberOfMatches = 0;
+    uint64_t numberOfRendered = 0;
+    for(auto it = endpointRules.lower_bound(filter.endpointPrefix);
+        it != endpointRules.end() && filter.matchPrefix(it->first);
+        it++)
+    {
+        if(filter.limit != 0
+                && numberOfRendered == filter.limit)
+        {
+            break;
+        }
+
+        // skip endpoints without any matching http-type
+        bool hasMatch = false;
+        for(const auto& [httpType, entry] : it->second)
+        {
+            if(selection.matchRule(it->first, httpType, entry))
+            {
+                hasMatch = true;
+                break;
+            }
+        }
+        if(hasMatch == false) {
+            continue;
+        }
+
+        numberOfMatches++;
+        if(numberOfMatches <= filter.offset) {
+            continue;
+        }
+
+        renderEndpoint(sink, langInterface, it->first, it->second, selection);
+        numberOfRendered++;
+        afterEndpoint();
+    }
+}
+
+/**
+ * @brief render the documentation of a single endpoint with all of its http-types
+ *
+ * @param sink target of the output
+ * @param langInterface pointer to the messaging-interface
+ * @param endpoint path of the endpoint
+ * @param rules blossoms of the endpoint for each http-type
+ * @param selection selection of the http-types
+ */
+template<typename FORMAT>
+template<typename SINK>
+void
+DocuRenderer<FORMAT>::renderEndpoint(SINK &sink,
+                                     HanamiMessaging* langInterface,
+                                     const std::string &endpoint,
+                                     const std::map<Hanami::HttpRequestType,
+                                                    Hanami::EndpointEntry> &rules,
+                                     const DocuSelection &selection)
+{
+    FORMAT::endpoint(sink, endpoint);
+
+    for(const auto& [httpType, entry] : rules)
+    {
+        if(selection.matchRule(endpoint, httpType, entry) == false) {
+            continue;
+        }
+
+        FORMAT::httpType(sink, getHttpTypeName(httpType));
+
+        Hanami::Blossom* blossom = langInterface->getBlossom(entry.group, entry.name);
+        if(blossom == nullptr) {
+            continue;
+        }
+
+        sink.append(blossom->comment);
+        sink.append("\n");
+
+        FORMAT::section(sink, "Request-Parameter");
+        renderFields(sink, *blossom->getInputValidationMap(), true);
+
+        FORMAT::section(sink, "Response-Parameter");
+        renderFields(sink, *blossom->getOutputValidationMap(), false);
+    }
+}
+
+/**
+ * @brief render the documentation of all fields of a blossom
+ *
+ * @param sink target of the output
+ * @param defMap map with all fields to document
+ * @param isRequest true to say that the fields are request-fields
+ */
+template<typename FORMAT>
+template<typename SINK>
+void
+DocuRenderer<FORMAT>::renderFields(SINK &sink,
+                                   const std::map<std::string, Hanami::FieldDef> &defMap,
+                                   const bool isRequest)
+{
+    char lowerBuffer[24];
+    char upperBuffer[24];
+
+    for(const auto& [name, def] : defMap)
+    {
+        FORMAT::field(sink, name, def.comment);
+
+        const std::string_view typeName = getFieldTypeName(def.fieldType);
+        if(typeName.size() > 0) {
+            FORMAT::attribute(sink, "Type", typeName);
+        }
+
+        if(isRequest == false) {
+            continue;
+        }
+
+        FORMAT::attribute(sink, "Required", def.isRequired ? "True" : "False");
+
+        if(def.defaultVal != nullptr
+                && def.isRequired == false)
+        {
+            FORMAT::attribute(sink, "Default", def.defaultVal->toString());
+        }
+
+        if(def.match != nullptr) {
+            FORMAT::attribute(sink, "Does have the value", def.match->toString());
+        }
+
+        if(def.regex.size() > 0) {
+            FORMAT::attribute(sink, "Must match the regex", def.regex);
+        }
+
+        if(def.lowerBorder == 0
+                && def.upperBorder == 0)
+        {
+            continue;
+        }
+
+        const char* lowerEnd = std::to_chars(lowerBuffer,
+                                             lowerBuffer + sizeof(lowerBuffer),
+                                             def.lowerBorder).ptr;
+        const char* upperEnd = std::to_chars(upperBuffer,
+                                             upperBuffer + sizeof(upperBuffer),
+                                             def.upperBorder).ptr;
+        const std::string_view lower(lowerBuffer, lowerEnd - lowerBuffer);
+        const std::string_view upper(upperBuffer, upperEnd - upperBuffer);
+
+        if(def.fieldType == Hanami::SAKURA_INT_TYPE)
+        {
+            FORMAT::attribute(sink, "Lower border of value", lower);
+            FORMAT::attribute(sink, "Upper border of value", upper);
+        }
+        if(def.fieldType == Hanami::SAKURA_STRING_TYPE)
+        {
+            FORMAT::attribute(sink, "Minimum string-length", lower);
+            FORMAT::attribute(sink, "Maximum string-length", upper);
+        }
+    }
+}
+
+// a new format only needs its format-struct and an instantiation here
+template class DocuRenderer<RstFormat>;
+template class DocuRenderer<MdFormat>;
+
+}  // namespace Misaki
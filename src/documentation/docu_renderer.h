@@ -0,0 +1,131 @@
+/**
+ * @file        docu_renderer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_RENDERER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_RENDERER_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <stdint.h>
+
+#include <documentation/docu_formats.h>
+#include <documentation/docu_filter.h>
+#include <documentation/docu_stream.h>
+#include <permission/policy_index.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+namespace Misaki
+{
+
+/**
+ * Sink, which only counts the bytes of the document.
+ */
+struct DocuSizeSink
+{
+    uint64_t size = 0;
+
+    void append(const std::string_view text) { size += text.size(); }
+    void append(const uint64_t count, const char) { size += count; }
+};
+
+/**
+ * Sink, which appends the document to a string.
+ */
+struct DocuStringSink
+{
+    std::string &output;
+
+    void append(const std::string_view text) { output.append(text); }
+    void append(const uint64_t count, const char c) { output.append(count, c); }
+};
+
+/**
+ * Filter of a document together with the compiled policy and the role-mask, which are used to
+ * check the access of the roles while rendering.
+ */
+struct DocuSelection
+{
+    const DocuFilter &filter;
+    const PolicyIndex* policy = nullptr;
+    std::vector<uint64_t> roleMask;
+
+    DocuSelection(const DocuFilter &filter)
+        : filter(filter) {}
+
+    bool matchRule(const std::string &endpoint,
+                   const Kitsunemimi::Hanami::HttpRequestType httpType,
+                   const Kitsunemimi::Hanami::EndpointEntry &entry) const
+    {
+        if(filter.matchRule(httpType, entry) == false) {
+            return false;
+        }
+
+        if(filter.restrictToRoles == false) {
+            return true;
+        }
+
+        return policy != nullptr
+               && policy->isAllowed(endpoint, httpType, roleMask);
+    }
+};
+
+/**
+ * Renderer of the api-documentation for a specific output-format. The size of the document is
+ * calculated first with the same code-path, so the output is allocated only once.
+ */
+template<typename FORMAT>
+class DocuRenderer
+{
+public:
+    static uint64_t calcSize(const std::string &localComponent,
+                             const DocuFilter &filter = DocuFilter());
+    static void render(std::string &docu,
+                       const std::string &localComponent,
+                       const DocuFilter &filter = DocuFilter());
+    static void render(DocuStream &stream,
+                       const std::string &localComponent,
+                       const DocuFilter &filter = DocuFilter());
+
+private:
+    template<typename SINK, typename FUNC>
+    static void renderDocu(SINK &sink,
+                           const std::string &localComponent,
+                           const DocuFilter &filter,
+                           FUNC afterEndpoint);
+    template<typename SINK>
+    static void renderEndpoint(SINK &sink,
+                               Kitsunemimi::Hanami::HanamiMessaging* langInterface,
+                               const std::string &endpoint,
+                               const std::map<Kitsunemimi::Hanami::HttpRequestType,
+                                              Kitsunemimi::Hanami::EndpointEntry> &rules,
+                               const DocuSelection &selection);
+    template<typename SINK>
+    static void renderFields(SINK &sink,
+                             const std::map<std::string, Kitsunemimi::Hanami::FieldDef> &defMap,
+                             const bool isRequest);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_RENDERER_H
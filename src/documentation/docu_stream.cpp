@@ -0,0 +1,135 @@
+/**
+ * @file        docu_stream.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <documentation/docu_stream.h>
+
+#include <common/base64.h>
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ *
+ * @param output string, where the document is written to
+ * @param encodeBase64 true to write the document base64-encoded
+ * @param chunkSize number of bytes, which are collected before they are written to the output
+ */
+DocuStream::DocuStream(std::string &output,
+                       const bool encodeBase64,
+                       const uint64_t chunkSize)
+    : m_output(output),
+      m_encodeBase64(encodeBase64),
+      m_chunkSize(chunkSize)
+{
+    m_buffer.reserve(m_chunkSize + m_chunkSize / 4);
+}
+
+/**
+ * @brief reserve the output for a document of a known size, so it is allocated only once
+ *
+ * @param rawSize size of the complete document before encoding
+ */
+void
+DocuStream::reserveOutput(const uint64_t rawSize)
+{
+    uint64_t outputSize = rawSize;
+    if(m_encodeBase64) {
+        outputSize = ((rawSize + 2) / 3) * 4;
+    }
+
+    m_output.reserve(m_output.size() + outputSize);
+}
+
+/**
+ * @brief get buffer for the next rendering-step
+ *
+ * @return reference to the buffer
+ */
+std::string&
+DocuStream::getBuffer()
+{
+    return m_buffer;
+}
+
+/**
+ * @brief write the buffer to the output, if at least one chunk was collected
+ */
+void
+DocuStream::flush()
+{
+    if(m_buffer.size() < m_chunkSize) {
+        return;
+    }
+
+    // keep the bytes, which doesn't fill a complete base64-block, for the next chunk
+    uint64_t numberOfBytes = m_buffer.size();
+    if(m_encodeBase64) {
+        numberOfBytes -= numberOfBytes % 3;
+    }
+
+    writeOut(numberOfBytes);
+}
+
+/**
+ * @brief write all remaining bytes to the output
+ */
+void
+DocuStream::finish()
+{
+    writeOut(m_buffer.size());
+}
+
+/**
+ * @brief get size of the document before encoding
+ *
+ * @return number of bytes, which were written to the output
+ */
+uint64_t
+DocuStream::getRawSize() const
+{
+    return m_rawSize;
+}
+
+/**
+ * @brief move the first bytes of the buffer to the output
+ *
+ * @param numberOfBytes number of bytes to move
+ */
+void
+DocuStream::writeOut(const uint64_t numberOfBytes)
+{
+    if(numberOfBytes == 0) {
+        return;
+    }
+
+    if(m_encodeBase64) {
+        appendBase64(m_output, m_buffer.c_str(), numberOfBytes);
+    } else {
+        m_output.append(m_buffer, 0, numberOfBytes);
+    }
+
+    m_buffer.erase(0, numberOfBytes);
+    m_rawSize += numberOfBytes;
+}
+
+}  // namespace Misaki
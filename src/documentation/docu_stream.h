@@ -0,0 +1,65 @@
+/**
+ * @file        docu_stream.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_STREAM_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_STREAM_H
+
+#include <string>
+#include <stdint.h>
+
+namespace Misaki
+{
+
+/**
+ * Target for the rendering of documents in multiple steps. Each step renders into a small
+ * buffer, which is moved to the output in chunks. If the output is base64-encoded, each chunk
+ * is encoded directly, so the complete document never exists in raw form. The chunks are cut
+ * at multiples of 3 bytes, so the concatenated chunks are identical to the encoding of the
+ * complete document.
+ */
+class DocuStream
+{
+public:
+    DocuStream(std::string &output,
+               const bool encodeBase64,
+               const uint64_t chunkSize = 64 * 1024);
+
+    void reserveOutput(const uint64_t rawSize);
+    std::string& getBuffer();
+    void flush();
+    void finish();
+
+    uint64_t getRawSize() const;
+
+private:
+    std::string &m_output;
+    const bool m_encodeBase64;
+    const uint64_t m_chunkSize;
+    std::string m_buffer = "";
+    uint64_t m_rawSize = 0;
+
+    void writeOut(const uint64_t numberOfBytes);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_STREAM_H
@@ -22,11 +22,12 @@
 
 #include "generate_api_docu.h"
 
-#include <rst_docu_generation.h>
-#include <md_docu_generation.h>
+#include <documentation/api_docu_cache.h>
+#include <documentation/docu_job_queue.h>
+#include <metrics/guard_metrics.h>
 
 #include <libKitsunemimiHanamiCommon/component_support.h>
-#include <libKitsunemimiCrypto/common.h>
+#include <libKitsunemimiCommon/methods/string_methods.h>
 
 using namespace Kitsunemimi;
 using Kitsunemimi::Hanami::SupportedComponents;
@@ -45,50 +46,217 @@ GenerateApiDocu::GenerateApiDocu()
     registerInputField("type",
                        Hanami::SAKURA_STRING_TYPE,
                        false,
-                       "Output-type of the document (pdf, rst, md).");
+                       "Output-type of the document (pdf, rst, md). Pdf is rendered in the "
+                       "background and only returns a job-id, which can be fetched at "
+                       "v1/documentation/api/job.");
     assert(addFieldDefault("type", new Kitsunemimi::DataValue("pdf")));
 
+    registerInputField("encoding",
+                       Hanami::SAKURA_STRING_TYPE,
+                       false,
+                       "Encoding of the document (base64, raw). Raw returns the document "
+                       "without conversion, if the transport can handle it. Compressed "
+                       "documents are binary, so they can only be requested with base64.");
+    assert(addFieldDefault("encoding", new Kitsunemimi::DataValue("base64")));
+    assert(addFieldRegex("encoding", "base64|raw"));
+
+    registerInputField("compression",
+                       Hanami::SAKURA_STRING_TYPE,
+                       false,
+                       "Compression of the document (none, gzip, zstd). The document is "
+                       "compressed before the encoding.");
+    assert(addFieldDefault("compression", new Kitsunemimi::DataValue("none")));
+    assert(addFieldRegex("compression", "none|gzip|zstd"));
+
+    registerInputField("known_hash",
+                       Hanami::SAKURA_STRING_TYPE,
+                       false,
+                       "Hash of the document, which is already known by the client. If it "
+                       "is still the actual hash, the document is not sent again.");
+    assert(addFieldDefault("known_hash", new Kitsunemimi::DataValue("")));
+
+    registerInputField("endpoint_prefix",
+                       Hanami::SAKURA_STRING_TYPE,
+                       false,
+                       "Only document endpoints, whose path starts with this prefix.");
+    assert(addFieldDefault("endpoint_prefix", new Kitsunemimi::DataValue("")));
+
+    registerInputField("group",
+                       Hanami::SAKURA_STRING_TYPE,
+                       false,
+                       "Only document endpoints, whose blossom belongs to this group.");
+    assert(addFieldDefault("group", new Kitsunemimi::DataValue("")));
+
+    registerInputField("http_methods",
+                       Hanami::SAKURA_STRING_TYPE,
+                       false,
+                       "Comma-separated list of the http-methods to document (GET, POST, PUT, "
+                       "DELETE). Empty for all methods.");
+    assert(addFieldDefault("http_methods", new Kitsunemimi::DataValue("")));
+    assert(addFieldRegex("http_methods", "((GET|POST|PUT|DELETE)(,(GET|POST|PUT|DELETE))*)?"));
+
+    registerInputField("offset",
+                       Hanami::SAKURA_INT_TYPE,
+                       false,
+                       "Number of matching endpoints, which are skipped.");
+    assert(addFieldDefault("offset", new Kitsunemimi::DataValue(0)));
+    assert(addFieldBorder("offset", 0, 1000000000));
+
+    registerInputField("limit",
+                       Hanami::SAKURA_INT_TYPE,
+                       false,
+                       "Maximum number of documented endpoints. 0 for no limit.");
+    assert(addFieldDefault("limit", new Kitsunemimi::DataValue(0)));
+    assert(addFieldBorder("limit", 0, 1000000000));
+
     //----------------------------------------------------------------------------------------------
     // output
     //----------------------------------------------------------------------------------------------
 
     registerOutputField("documentation",
                         Hanami::SAKURA_STRING_TYPE,
-                        "API-documentation as base64 converted string.");
+                        "API-documentation as base64 converted string or as raw string, "
+                        "depending on the requested encoding and compression. Empty for pdf.");
+    registerOutputField("job_id",
+                        Hanami::SAKURA_STRING_TYPE,
+                        "Id of the background-job, which renders the pdf. Empty for other "
+                        "types.");
+    registerOutputField("hash",
+                        Hanami::SAKURA_STRING_TYPE,
+                        "Hash of the document, which changes with the API.");
+    registerOutputField("modified",
+                        Hanami::SAKURA_BOOL_TYPE,
+                        "False, if the document is not modified since the known hash. In this "
+                        "case documentation and job-id are empty.");
 
     //----------------------------------------------------------------------------------------------
     //
     //----------------------------------------------------------------------------------------------
 }
 
+/**
+ * @brief convert the filter-fields of the request into a filter for the documentation
+ *
+ * @param input input of the request
+ *
+ * @return filter of the requested endpoints
+ */
+static DocuFilter
+getDocuFilter(const JsonItem &input)
+{
+    DocuFilter filter;
+    filter.endpointPrefix = input.get("endpoint_prefix").getString();
+    filter.group = input.get("group").getString();
+    filter.offset = static_cast<uint64_t>(input.get("offset").getLong());
+    filter.limit = static_cast<uint64_t>(input.get("limit").getLong());
+
+    std::vector<std::string> httpMethods;
+    splitStringByDelimiter(httpMethods, input.get("http_methods").getString(), ',');
+    for(const std::string &httpMethod : httpMethods)
+    {
+        if(httpMethod == "GET") {
+            filter.httpTypes |= 1u << Hanami::GET_TYPE;
+        } else if(httpMethod == "POST") {
+            filter.httpTypes |= 1u << Hanami::POST_TYPE;
+        } else if(httpMethod == "PUT") {
+            filter.httpTypes |= 1u << Hanami::PUT_TYPE;
+        } else if(httpMethod == "DELETE") {
+            filter.httpTypes |= 1u << Hanami::DELETE_TYPE;
+        }
+    }
+
+    return filter;
+}
+
 /**
  * @brief runTask
  */
 bool
 GenerateApiDocu::runTask(Hanami::BlossomIO &blossomIO,
-                         const DataMap &,
-                         Hanami::BlossomStatus &,
-                         ErrorContainer &)
+                         const DataMap &context,
+                         Hanami::BlossomStatus &status,
+                         ErrorContainer &error)
 {
     const std::string localComponent = SupportedComponents::getInstance()->localComponent;
     const std::string type = blossomIO.input.get("type").getString();
+    const bool encodeBase64 = blossomIO.input.get("encoding").getString() != "raw";
+    const DocuCompression compression =
+            getDocuCompression(blossomIO.input.get("compression").getString());
 
-    std::string documentsion = "";
+    GuardMetrics::increaseCounter(DOCU_REQUEST_COUNTER);
 
-    if(type == "rst"
-            || type == "pdf")
+    // compressed documents are binary and would be broken within the string of the output
+    if(compression != NO_DOCU_COMPRESSION
+            && encodeBase64 == false)
     {
-        createRstDocumentation(documentsion, localComponent);
+        status.statusCode = Hanami::BAD_REQUEST_RTYPE;
+        status.errorMessage = "Compressed documentation can only be requested with base64-encoding";
+        error.addMeesage(status.errorMessage);
+        return false;
     }
-    else if(type == "md")
+
+    const std::string knownHash = blossomIO.input.get("known_hash").getString();
+    DocuFilter filter = getDocuFilter(blossomIO.input);
+    ApiDocuCache::addRoleRestriction(filter, context);
+    const DocuFormat format = ApiDocuCache::getDocuFormat(type);
+
+    // check hash before anything is rendered or encoded. The hash is calculated without
+    // rendering, so pdf-requests don't render on the thread of the request
+    const uint64_t hash = ApiDocuCache::getInstance()->getContentHash(format,
+                                                                      localComponent,
+                                                                      filter);
+    const std::string hashString = ApiDocuCache::convertHashToString(hash);
+    blossomIO.output.insert("hash", hashString);
+    if(knownHash == hashString)
     {
-        createMdDocumentation(documentsion, localComponent);
+        GuardMetrics::increaseCounter(DOCU_NOT_MODIFIED_COUNTER);
+        blossomIO.output.insert("modified", false);
+        blossomIO.output.insert("documentation", "");
+        blossomIO.output.insert("job_id", "");
+        return true;
     }
+    blossomIO.output.insert("modified", true);
+
+    // pdf is the expensive type, so it is not rendered on the thread of the request
+    if(type == "pdf")
+    {
+        std::string jobId;
+        if(DocuJobQueue::getInstance()->addJob(jobId,
+                                               format,
+                                               compression,
+                                               encodeBase64,
+                                               localComponent,
+                                               filter) == false)
+        {
+            status.statusCode = Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+            status.errorMessage = "Too many pending documentation-jobs";
+            error.addMeesage(status.errorMessage);
+            return false;
+        }
 
-    std::string base64Docu;
-    encodeBase64(base64Docu, documentsion.c_str(), documentsion.size());
+        blossomIO.output.insert("documentation", "");
+        blossomIO.output.insert("job_id", jobId);
+
+        return true;
+    }
+
+    const std::shared_ptr<const std::string> docu =
+            ApiDocuCache::getInstance()->getDocu(format,
+                                                 compression,
+                                                 encodeBase64,
+                                                 localComponent,
+                                                 filter,
+                                                 error);
+    if(docu == nullptr)
+    {
+        status.statusCode = Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        status.errorMessage = "Failed to create documentation";
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
 
-    blossomIO.output.insert("documentation", base64Docu);
+    blossomIO.output.insert("documentation", *docu);
+    blossomIO.output.insert("job_id", "");
 
     return true;
 }
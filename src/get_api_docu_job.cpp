@@ -0,0 +1,98 @@
+/**
+ * @file        get_api_docu_job.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "get_api_docu_job.h"
+
+#include <documentation/docu_job_queue.h>
+#include <documentation/api_docu_cache.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+GetApiDocuJob::GetApiDocuJob()
+    : Hanami::Blossom("Get the state of a background-job, which renders the documentation of "
+                      "the API, and the document, if the job is finished.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("job_id",
+                       Hanami::SAKURA_STRING_TYPE,
+                       true,
+                       "Id of the job, which was returned by the request of the documentation.");
+    assert(addFieldRegex("job_id", "[0-9a-f]{32}"));
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("state",
+                        Hanami::SAKURA_STRING_TYPE,
+                        "State of the job (queued, running, finished, failed).");
+    registerOutputField("documentation",
+                        Hanami::SAKURA_STRING_TYPE,
+                        "API-documentation with the requested encoding, if the job is finished, "
+                        "else empty.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+GetApiDocuJob::runTask(Hanami::BlossomIO &blossomIO,
+                       const DataMap &context,
+                       Hanami::BlossomStatus &status,
+                       ErrorContainer &error)
+{
+    const std::string jobId = blossomIO.input.get("job_id").getString();
+
+    // jobs of other roles are handled like unknown jobs, so their existence is not revealed
+    DocuFilter filter;
+    ApiDocuCache::addRoleRestriction(filter, context);
+    const DocuJobStatus jobStatus = DocuJobQueue::getInstance()->getJobStatus(jobId,
+                                                                             filter.getRoleKey());
+    if(jobStatus.state == UNKNOWN_DOCU_JOB_STATE)
+    {
+        status.statusCode = Hanami::NOT_FOUND_RTYPE;
+        status.errorMessage = "Documentation-job with id '" + jobId + "' not found";
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    blossomIO.output.insert("state", DocuJobQueue::getStateName(jobStatus.state));
+    if(jobStatus.docu != nullptr) {
+        blossomIO.output.insert("documentation", *jobStatus.docu);
+    } else {
+        blossomIO.output.insert("documentation", "");
+    }
+
+    return true;
+}
+
+}  // namespace Misaki
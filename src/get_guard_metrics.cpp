@@ -0,0 +1,76 @@
+/**
+ * @file        get_guard_metrics.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "get_guard_metrics.h"
+
+#include <metrics/guard_metrics.h>
+#include <validation/verified_token_cache.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+GetGuardMetrics::GetGuardMetrics()
+    : Hanami::Blossom("Get counters and latency-histograms of the misaki-guard "
+                      "of the current component.")
+{
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("metrics",
+                        Hanami::SAKURA_MAP_TYPE,
+                        "Counters and histograms with count, sum, max and percentiles.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+GetGuardMetrics::runTask(Hanami::BlossomIO &blossomIO,
+                         const DataMap &,
+                         Hanami::BlossomStatus &,
+                         ErrorContainer &)
+{
+    JsonItem metrics = GuardMetrics::toJson();
+
+    // the cache of verified tokens already counts by itself
+    VerifiedTokenCacheStats stats;
+    VerifiedTokenCache::getInstance()->getStats(stats);
+
+    std::map<std::string, JsonItem> verifiedTokenCache;
+    verifiedTokenCache.emplace("hits", JsonItem(static_cast<long>(stats.hits)));
+    verifiedTokenCache.emplace("misses", JsonItem(static_cast<long>(stats.misses)));
+    verifiedTokenCache.emplace("evictions", JsonItem(static_cast<long>(stats.evictions)));
+    metrics.insert("verified_token_cache", JsonItem(verifiedTokenCache));
+
+    blossomIO.output.insert("metrics", metrics);
+
+    return true;
+}
+
+}  // namespace Misaki
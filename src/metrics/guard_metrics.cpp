@@ -0,0 +1,371 @@
+/**
+ * @file        guard_metrics.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <metrics/guard_metrics.h>
+
+#include <map>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+std::mutex GuardMetrics::m_lock;
+std::vector<GuardMetrics::ThreadMetrics*> GuardMetrics::m_allThreadMetrics;
+std::vector<GuardMetrics::ThreadMetrics*> GuardMetrics::m_freeThreadMetrics;
+GuardMetrics::ThreadMetrics GuardMetrics::m_retiredMetrics;
+
+static const std::vector<std::string> counterNames = {
+    "token_cache_hits",
+    "token_cache_misses",
+    "token_fetches",
+    "token_fetch_errors",
+    "permission_cache_hits",
+    "permission_cache_misses",
+    "documentation_requests",
+    "documentation_cache_hits",
+    "documentation_cache_misses",
+    "documentation_jobs",
+    "documentation_jobs_rejected",
+    "documentation_not_modified",
+};
+
+static const std::vector<std::string> histogramNames = {
+    "token_fetch_latency_ns",
+    "token_parse_latency_ns",
+    "documentation_render_latency_ns",
+    "documentation_size_bytes",
+};
+
+/**
+ * @brief constructor
+ */
+GuardMetrics::ThreadMetrics::ThreadMetrics()
+{
+    reset();
+}
+
+/**
+ * @brief set all values of the block back to zero
+ */
+void
+GuardMetrics::ThreadMetrics::reset()
+{
+    for(uint32_t i = 0; i < NUMBER_OF_COUNTERS; i++) {
+        counters[i].store(0, std::memory_order_relaxed);
+    }
+
+    for(uint32_t h = 0; h < NUMBER_OF_HISTOGRAMS; h++)
+    {
+        for(uint32_t b = 0; b < NUMBER_OF_BUCKETS; b++) {
+            buckets[h][b].store(0, std::memory_order_relaxed);
+        }
+        sums[h].store(0, std::memory_order_relaxed);
+        maxValues[h].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief add all values of the block to another block
+ *
+ * @param target block, which gets the values
+ */
+void
+GuardMetrics::ThreadMetrics::addTo(ThreadMetrics &target) const
+{
+    for(uint32_t i = 0; i < NUMBER_OF_COUNTERS; i++) {
+        target.counters[i].fetch_add(counters[i].load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+    }
+
+    for(uint32_t h = 0; h < NUMBER_OF_HISTOGRAMS; h++)
+    {
+        for(uint32_t b = 0; b < NUMBER_OF_BUCKETS; b++)
+        {
+            target.buckets[h][b].fetch_add(buckets[h][b].load(std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+        }
+        target.sums[h].fetch_add(sums[h].load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+
+        const uint64_t maxValue = maxValues[h].load(std::memory_order_relaxed);
+        if(maxValue > target.maxValues[h].load(std::memory_order_relaxed)) {
+            target.maxValues[h].store(maxValue, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief destructor, which runs at the end of the owning thread. It folds the values of the
+ *        thread into the retired values and puts the block into the free-list for reuse.
+ *        Both happens under the lock, so a reader sees the values exactly once.
+ */
+GuardMetrics::ThreadMetricsSlot::~ThreadMetricsSlot()
+{
+    if(metrics == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    metrics->addTo(m_retiredMetrics);
+    metrics->reset();
+
+    for(uint64_t i = 0; i < m_allThreadMetrics.size(); i++)
+    {
+        if(m_allThreadMetrics[i] == metrics)
+        {
+            m_allThreadMetrics[i] = m_allThreadMetrics.back();
+            m_allThreadMetrics.pop_back();
+            break;
+        }
+    }
+
+    m_freeThreadMetrics.push_back(metrics);
+    metrics = nullptr;
+}
+
+/**
+ * @brief get block of metrics of the calling thread. The block is taken from the free-list
+ *        if possible and given back at the end of the thread.
+ */
+GuardMetrics::ThreadMetrics*
+GuardMetrics::getThreadMetrics()
+{
+    thread_local ThreadMetricsSlot slot;
+    if(slot.metrics == nullptr)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if(m_freeThreadMetrics.size() > 0)
+        {
+            slot.metrics = m_freeThreadMetrics.back();
+            m_freeThreadMetrics.pop_back();
+        }
+        else
+        {
+            slot.metrics = new ThreadMetrics();
+        }
+        m_allThreadMetrics.push_back(slot.metrics);
+    }
+
+    return slot.metrics;
+}
+
+/**
+ * @brief increase a counter
+ *
+ * @param counter counter to increase
+ * @param value value to add
+ */
+void
+GuardMetrics::increaseCounter(const MetricCounter counter,
+                              const uint64_t value)
+{
+    getThreadMetrics()->counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief record a value into a histogram
+ *
+ * @param histogram target-histogram
+ * @param value value to record
+ */
+void
+GuardMetrics::recordValue(const MetricHistogram histogram,
+                          const uint64_t value)
+{
+    ThreadMetrics* threadMetrics = getThreadMetrics();
+
+    threadMetrics->buckets[histogram][getBucketPos(value)].fetch_add(1, std::memory_order_relaxed);
+    threadMetrics->sums[histogram].fetch_add(value, std::memory_order_relaxed);
+
+    // only the own thread writes the max-value, so no compare-exchange-loop is necessary
+    if(value > threadMetrics->maxValues[histogram].load(std::memory_order_relaxed)) {
+        threadMetrics->maxValues[histogram].store(value, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief get sum of a counter over all threads
+ *
+ * @param counter requested counter
+ *
+ * @return value of the counter
+ */
+uint64_t
+GuardMetrics::getCounter(const MetricCounter counter)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    uint64_t result = m_retiredMetrics.counters[counter].load(std::memory_order_relaxed);
+    for(const ThreadMetrics* threadMetrics : m_allThreadMetrics) {
+        result += threadMetrics->counters[counter].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+/**
+ * @brief merge the histograms of all threads and calculate count, sum, max and percentiles
+ *
+ * @param summary reference for the result
+ * @param histogram requested histogram
+ */
+void
+GuardMetrics::getHistogram(HistogramSummary &summary,
+                           const MetricHistogram histogram)
+{
+    std::vector<uint64_t> buckets(NUMBER_OF_BUCKETS, 0);
+    summary = HistogramSummary();
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        std::vector<const ThreadMetrics*> allMetrics(m_allThreadMetrics.begin(),
+                                                     m_allThreadMetrics.end());
+        allMetrics.push_back(&m_retiredMetrics);
+
+        for(const ThreadMetrics* threadMetrics : allMetrics)
+        {
+            for(uint32_t b = 0; b < NUMBER_OF_BUCKETS; b++)
+            {
+                const uint64_t value = threadMetrics->buckets[histogram][b].load(
+                                            std::memory_order_relaxed);
+                buckets[b] += value;
+                summary.count += value;
+            }
+
+            summary.sum += threadMetrics->sums[histogram].load(std::memory_order_relaxed);
+            summary.max = std::max(summary.max,
+                                   threadMetrics->maxValues[histogram].load(
+                                       std::memory_order_relaxed));
+        }
+    }
+
+    if(summary.count == 0) {
+        return;
+    }
+
+    // get percentiles
+    const std::vector<std::pair<double, uint64_t*>> percentiles = {
+        {0.5, &summary.p50},
+        {0.9, &summary.p90},
+        {0.99, &summary.p99},
+        {0.999, &summary.p999},
+    };
+
+    uint64_t seen = 0;
+    uint32_t percentilePos = 0;
+    for(uint32_t b = 0; b < NUMBER_OF_BUCKETS && percentilePos < percentiles.size(); b++)
+    {
+        seen += buckets[b];
+        while(percentilePos < percentiles.size()
+              && static_cast<double>(seen)
+                 >= percentiles[percentilePos].first * static_cast<double>(summary.count))
+        {
+            *percentiles[percentilePos].second = std::min(getBucketValue(b), summary.max);
+            percentilePos++;
+        }
+    }
+}
+
+/**
+ * @brief convert all metrics into a json-object
+ *
+ * @return json-object with one entry per counter and histogram
+ */
+JsonItem
+GuardMetrics::toJson()
+{
+    std::map<std::string, JsonItem> counters;
+    for(uint32_t i = 0; i < NUMBER_OF_COUNTERS; i++)
+    {
+        const uint64_t value = getCounter(static_cast<MetricCounter>(i));
+        counters.emplace(counterNames.at(i), JsonItem(static_cast<long>(value)));
+    }
+
+    std::map<std::string, JsonItem> histograms;
+    for(uint32_t i = 0; i < NUMBER_OF_HISTOGRAMS; i++)
+    {
+        HistogramSummary summary;
+        getHistogram(summary, static_cast<MetricHistogram>(i));
+
+        std::map<std::string, JsonItem> values;
+        values.emplace("count", JsonItem(static_cast<long>(summary.count)));
+        values.emplace("sum", JsonItem(static_cast<long>(summary.sum)));
+        values.emplace("max", JsonItem(static_cast<long>(summary.max)));
+        values.emplace("p50", JsonItem(static_cast<long>(summary.p50)));
+        values.emplace("p90", JsonItem(static_cast<long>(summary.p90)));
+        values.emplace("p99", JsonItem(static_cast<long>(summary.p99)));
+        values.emplace("p999", JsonItem(static_cast<long>(summary.p999)));
+        histograms.emplace(histogramNames.at(i), JsonItem(values));
+    }
+
+    std::map<std::string, JsonItem> result;
+    result.emplace("counters", JsonItem(counters));
+    result.emplace("histograms", JsonItem(histograms));
+
+    return JsonItem(result);
+}
+
+/**
+ * @brief get bucket of a value
+ *
+ * @param value value to record
+ *
+ * @return position of the bucket
+ */
+uint32_t
+GuardMetrics::getBucketPos(const uint64_t value)
+{
+    if(value < 16) {
+        return static_cast<uint32_t>(value);
+    }
+
+    const uint32_t exponent = 63 - static_cast<uint32_t>(__builtin_clzll(value));
+    const uint32_t subBucket = static_cast<uint32_t>(value >> (exponent - 3)) & 7;
+
+    return 16 + (exponent - 4) * NUMBER_OF_SUB_BUCKETS + subBucket;
+}
+
+/**
+ * @brief get upper bound of the values within a bucket
+ *
+ * @param bucketPos position of the bucket
+ *
+ * @return highest value, which belongs to the bucket
+ */
+uint64_t
+GuardMetrics::getBucketValue(const uint32_t bucketPos)
+{
+    if(bucketPos < 16) {
+        return bucketPos;
+    }
+
+    const uint32_t exponent = ((bucketPos - 16) / NUMBER_OF_SUB_BUCKETS) + 4;
+    const uint64_t subBucket = (bucketPos - 16) % NUMBER_OF_SUB_BUCKETS;
+    const uint64_t lowerBound = (8 + subBucket) << (exponent - 3);
+
+    return lowerBound + (1ULL << (exponent - 3)) - 1;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,155 @@
+/**
+ * @file        guard_metrics.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_GUARD_METRICS_H
+#define KITSUNEMIMI_HANAMI_MISAKI_GUARD_METRICS_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <libKitsunemimiJson/json_item.h>
+
+namespace Misaki
+{
+
+enum MetricCounter
+{
+    TOKEN_CACHE_HIT_COUNTER = 0,
+    TOKEN_CACHE_MISS_COUNTER = 1,
+    TOKEN_FETCH_COUNTER = 2,
+    TOKEN_FETCH_ERROR_COUNTER = 3,
+    PERMISSION_CACHE_HIT_COUNTER = 4,
+    PERMISSION_CACHE_MISS_COUNTER = 5,
+    DOCU_REQUEST_COUNTER = 6,
+    DOCU_CACHE_HIT_COUNTER = 7,
+    DOCU_CACHE_MISS_COUNTER = 8,
+    DOCU_JOB_COUNTER = 9,
+    DOCU_JOB_REJECTED_COUNTER = 10,
+    DOCU_NOT_MODIFIED_COUNTER = 11,
+    NUMBER_OF_COUNTERS = 12,
+};
+
+enum MetricHistogram
+{
+    TOKEN_FETCH_LATENCY_NS = 0,
+    TOKEN_PARSE_LATENCY_NS = 1,
+    DOCU_RENDER_LATENCY_NS = 2,
+    DOCU_SIZE_BYTES = 3,
+    NUMBER_OF_HISTOGRAMS = 4,
+};
+
+/**
+ * Counters and histograms of the guard. Every thread writes into its own block of metrics, so
+ * recording a value is a relaxed atomic add on a thread-local cache-line. Only the reader
+ * collects the blocks of all threads. When a thread ends, its values are folded into a shared
+ * block of retired values and its block is recycled for the next new thread.
+ *
+ * The histograms have a log-linear bucket-layout like HDR-histograms: values below 16 have
+ * their own bucket and every power of two above is split into 8 sub-buckets, so the relative
+ * error is at most 12.5 percent over the whole range of 64 bit.
+ */
+class GuardMetrics
+{
+public:
+    static const uint32_t NUMBER_OF_SUB_BUCKETS = 8;
+    static const uint32_t NUMBER_OF_BUCKETS = 16 + (64 - 4) * NUMBER_OF_SUB_BUCKETS;
+
+    struct HistogramSummary
+    {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+    };
+
+    static void increaseCounter(const MetricCounter counter,
+                                const uint64_t value = 1);
+    static void recordValue(const MetricHistogram histogram,
+                            const uint64_t value);
+
+    static uint64_t getCounter(const MetricCounter counter);
+    static void getHistogram(HistogramSummary &summary,
+                             const MetricHistogram histogram);
+    static Kitsunemimi::JsonItem toJson();
+
+    static uint32_t getBucketPos(const uint64_t value);
+    static uint64_t getBucketValue(const uint32_t bucketPos);
+
+private:
+    struct alignas(64) ThreadMetrics
+    {
+        std::atomic<uint64_t> counters[NUMBER_OF_COUNTERS];
+        std::atomic<uint64_t> buckets[NUMBER_OF_HISTOGRAMS][NUMBER_OF_BUCKETS];
+        std::atomic<uint64_t> sums[NUMBER_OF_HISTOGRAMS];
+        std::atomic<uint64_t> maxValues[NUMBER_OF_HISTOGRAMS];
+
+        ThreadMetrics();
+        void reset();
+        void addTo(ThreadMetrics &target) const;
+    };
+
+    struct ThreadMetricsSlot
+    {
+        ThreadMetrics* metrics = nullptr;
+        ~ThreadMetricsSlot();
+    };
+
+    static ThreadMetrics* getThreadMetrics();
+
+    static std::mutex m_lock;
+    static std::vector<ThreadMetrics*> m_allThreadMetrics;
+    static std::vector<ThreadMetrics*> m_freeThreadMetrics;
+    static ThreadMetrics m_retiredMetrics;
+};
+
+/**
+ * Measures the time between creation and destruction in nanoseconds and records it into
+ * a histogram.
+ */
+class ScopedLatency
+{
+public:
+    ScopedLatency(const MetricHistogram histogram)
+        : m_histogram(histogram),
+          m_start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency()
+    {
+        const auto duration = std::chrono::steady_clock::now() - m_start;
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        GuardMetrics::recordValue(m_histogram, static_cast<uint64_t>(ns));
+    }
+
+private:
+    const MetricHistogram m_histogram;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_GUARD_METRICS_H
@@ -22,13 +22,26 @@
 
 #include <libMisakiGuard/misaki_input.h>
 #include <generate_api_docu.h>
+#include <get_guard_metrics.h>
+#include <get_api_docu_job.h>
+#include <token/token_cache.h>
+#include <token/token_fetcher.h>
+#include <token/token_refresher.h>
+#include <common/misaki_call_guard.h>
+#include <validation/token_validator.h>
+#include <validation/verified_token_cache.h>
+#include <validation/key_store.h>
+#include <validation/revocation_filter.h>
+#include <validation/request_validator_store.h>
+#include <permission/permission_cache.h>
+#include <permission/permission_checker.h>
+#include <permission/policy_store.h>
+#include <documentation/api_docu_cache.h>
+#include <documentation/docu_job_queue.h>
+#include <metrics/guard_metrics.h>
 
-#include <libKitsunemimiJson/json_item.h>
-
-#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
 
-using Kitsunemimi::Hanami::HanamiMessagingClient;
 using Kitsunemimi::Hanami::HanamiMessaging;
 
 namespace Misaki
@@ -48,6 +61,12 @@ initMisakiBlossoms()
     if(interface->addBlossom(group, "get_api_documentation", new GenerateApiDocu()) == false) {
         return false;
     }
+    if(interface->addBlossom(group, "get_guard_metrics", new GetGuardMetrics()) == false) {
+        return false;
+    }
+    if(interface->addBlossom(group, "get_api_documentation_job", new GetApiDocuJob()) == false) {
+        return false;
+    }
 
     // add new endpoints
     if(interface->addEndpoint("v1/documentation/api",
@@ -58,10 +77,130 @@ initMisakiBlossoms()
     {
         return false;
     }
+    if(interface->addEndpoint("v1/guard/metrics",
+                              Kitsunemimi::Hanami::GET_TYPE,
+                              Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                              group,
+                              "get_guard_metrics") == false)
+    {
+        return false;
+    }
+    if(interface->addEndpoint("v1/documentation/api/job",
+                              Kitsunemimi::Hanami::GET_TYPE,
+                              Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                              group,
+                              "get_api_documentation_job") == false)
+    {
+        return false;
+    }
+
+    // precompile the input-validation of all registered endpoints
+    Kitsunemimi::ErrorContainer error;
+    if(RequestValidatorStore::getInstance()->build(error) == false)
+    {
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // the documentation-cache compares only the precalculated version of the registry
+    ApiDocuCache::getInstance()->updateRegistryVersion();
 
     return true;
 }
 
+/**
+ * @brief stop all background-threads of the guard and wait until they are finished. Must be
+ *        called before the process exits or the messaging-interface is closed.
+ */
+void
+shutdownMisakiGuard()
+{
+    KeyStore::getInstance()->stopWatching();
+    RevocationFilter::getInstance()->stopPulling();
+    DocuJobQueue::getInstance()->shutdown();
+    TokenRefresher::getInstance()->stopRefresh();
+    TokenFetcher::getInstance()->shutdown();
+}
+
+
+/**
+ * @brief get internal token of a component from the cache without blocking
+ *
+ * @param token reference for the resulting token
+ * @param componentName name of the component where the token is for
+ *
+ * @return true, if a usable token was found, else false
+ */
+static bool
+getCachedInternalToken(std::string &token,
+                       const std::string &componentName)
+{
+    TokenCache* tokenCache = TokenCache::getInstance();
+
+    // try to use a cached token, which is still valid long enough
+    if(tokenCache->getToken(token, componentName))
+    {
+        GuardMetrics::increaseCounter(TOKEN_CACHE_HIT_COUNTER);
+        return true;
+    }
+
+    // while the refresher is active, it is responsible to renew the token, so the old one is
+    // still served, until it is really expired, instead of blocking on misaki
+    if(TokenRefresher::getInstance()->isRunning()
+            && tokenCache->getUnexpiredToken(token, componentName))
+    {
+        GuardMetrics::increaseCounter(TOKEN_CACHE_HIT_COUNTER);
+        return true;
+    }
+
+    GuardMetrics::increaseCounter(TOKEN_CACHE_MISS_COUNTER);
+    return false;
+}
+
+/**
+ * @brief wait for the result of a token-request until the deadline is reached. If the request
+ *        failed or the deadline was reached, a cached token is used as long as it is not
+ *        expired.
+ *
+ * @param componentName name of the component where the token is for
+ * @param future future of the running request
+ * @param deadline point in time, where the waiting is aborted
+ *
+ * @return result of the request
+ */
+static InternalTokenResult
+waitForInternalToken(const std::string &componentName,
+                     const std::shared_future<InternalTokenResult> &future,
+                     const std::chrono::steady_clock::time_point &deadline)
+{
+    InternalTokenResult result;
+    if(future.wait_until(deadline) == std::future_status::ready)
+    {
+        result = future.get();
+        if(result.success) {
+            return result;
+        }
+    }
+    else
+    {
+        result.error.addMeesage("Deadline for the request of a internal jwt-token reached");
+    }
+
+    // serve the old token, while misaki is not available
+    if(TokenCache::getInstance()->getUnexpiredToken(result.token, componentName))
+    {
+        LOG_WARNING("Request of a new internal jwt-token for component '" + componentName
+                    + "' failed. Use cached token until it expires.");
+        result.success = true;
+        return result;
+    }
+
+    result.error.addMeesage("Failed to get internal jwt-token for component '"
+                            + componentName + "'");
+    result.success = false;
+
+    return result;
+}
 
 /**
  * @brief HanamiMessaging::getInternalToken
@@ -77,50 +216,460 @@ getInternalToken(std::string &token,
                  const std::string &componentName,
                  Kitsunemimi::ErrorContainer &error)
 {
-    HanamiMessagingClient* misakiClient = HanamiMessaging::getInstance()->misakiClient;
-    Kitsunemimi::Hanami::ResponseMessage response;
-
-    // create request
-    Kitsunemimi::Hanami::RequestMessage request;
-    request.id = "v1/token/internal";
-    request.httpType = Kitsunemimi::Hanami::POST_TYPE;
-    request.inputValues = "{\"service_name\":\"" + componentName + "\"}";
+    if(getCachedInternalToken(token, componentName)) {
+        return true;
+    }
 
-    // request internal jwt-token from misaki
-    if(misakiClient->triggerSakuraFile(response, request, error) == false)
+    // wait for the request, which is maybe already triggered by another thread
+    const InternalTokenResult result =
+            waitForInternalToken(componentName,
+                                 TokenFetcher::getInstance()->fetch(componentName),
+                                 MisakiCallGuard::getInstance()->getDeadline());
+    if(result.success == false)
     {
-        error.addMeesage("Failed to trigger misaki to get a internal jwt-token");
-        LOG_ERROR(error);
+        error = result.error;
         return false;
     }
 
-    // check response
-    if(response.success == false)
+    token = result.token;
+
+    return true;
+}
+
+/**
+ * @brief get internal jwt-tokens for multiple components at once. Tokens, which are not
+ *        cached, are requested from misaki in one parallel burst.
+ *
+ * @param results reference for the results, with one entry per component, which contains the
+ *                token or the error-message for this component
+ * @param componentNames names of the components where the tokens are for
+ *
+ * @return true, if all tokens were successfully fetched, else false
+ */
+bool
+getInternalTokens(std::map<std::string, InternalTokenResult> &results,
+                  const std::vector<std::string> &componentNames)
+{
+    std::map<std::string, std::shared_future<InternalTokenResult>> pendingRequests;
+
+    // use cached tokens where possible and send requests for all others at once
+    for(const std::string &componentName : componentNames)
     {
-        error.addMeesage("Failed to trigger misaki to get a internal jwt-token (no success)");
-        LOG_ERROR(error);
-        return false;
+        InternalTokenResult result;
+        if(getCachedInternalToken(result.token, componentName))
+        {
+            result.success = true;
+            results[componentName] = result;
+            continue;
+        }
+
+        pendingRequests.emplace(componentName, TokenFetcher::getInstance()->fetch(componentName));
     }
 
-    // parse response
-    Kitsunemimi::JsonItem jsonItem;
-    if(jsonItem.parse(response.responseContent, error) == false)
+    // collect results of the requests, where all requests share the same deadline
+    const std::chrono::steady_clock::time_point deadline =
+            MisakiCallGuard::getInstance()->getDeadline();
+    bool allSuccessful = true;
+    for(const auto& [componentName, pendingRequest] : pendingRequests)
     {
-        error.addMeesage("Failed to parse internal jwt-token from response of misaki");
-        LOG_ERROR(error);
-        return false;
+        const InternalTokenResult result = waitForInternalToken(componentName,
+                                                                pendingRequest,
+                                                                deadline);
+        allSuccessful &= result.success;
+        results[componentName] = result;
     }
 
-    // get token from response
-    token = jsonItem.getItemContent()->toMap()->getStringByKey("token");
-    if(token == "")
+    return allSuccessful;
+}
+
+/**
+ * @brief get internal jwt-token without blocking the calling thread. Concurrent calls for the
+ *        same component share a single request to misaki.
+ *
+ * @param componentName name of the component where the token is for
+ *
+ * @return future, which gets the token or the error-message
+ */
+std::shared_future<InternalTokenResult>
+getInternalTokenAsync(const std::string &componentName)
+{
+    InternalTokenResult result;
+    if(getCachedInternalToken(result.token, componentName))
     {
-        error.addMeesage("Internal jwt-token from misaki is empty");
-        LOG_ERROR(error);
+        result.success = true;
+        std::promise<InternalTokenResult> promise;
+        promise.set_value(result);
+        return promise.get_future().share();
+    }
+
+    return TokenFetcher::getInstance()->fetch(componentName);
+}
+
+/**
+ * @brief get internal jwt-token without blocking the calling thread. Concurrent calls for the
+ *        same component share a single request to misaki.
+ *
+ * @param componentName name of the component where the token is for
+ * @param callback callback, which is called with the token or the error-message. If the token
+ *                 is cached, it is called directly by the calling thread, else by the thread
+ *                 of the worker-pool, which processed the request.
+ */
+void
+getInternalTokenAsync(const std::string &componentName,
+                      const InternalTokenCallback &callback)
+{
+    InternalTokenResult result;
+    if(getCachedInternalToken(result.token, componentName))
+    {
+        result.success = true;
+        callback(result);
+        return;
+    }
+
+    TokenFetcher::getInstance()->fetch(componentName, callback);
+}
+
+/**
+ * @brief set deadline, retries and circuit-breaker-configuration for requests to misaki. The
+ *        deadline stops further tries and backoffs, but not a single try, which hangs within
+ *        the messaging-client, because the client has no timeout per request.
+ *
+ * @param config new configuration
+ */
+void
+setMisakiCallConfig(const MisakiCallConfig &config)
+{
+    MisakiCallGuard::getInstance()->setConfig(config);
+}
+
+/**
+ * @brief get actual state of the circuit-breaker for requests to misaki
+ *
+ * @return state of the circuit
+ */
+CircuitState
+getMisakiCircuitState()
+{
+    return MisakiCallGuard::getInstance()->getCircuitBreaker()->getState();
+}
+
+/**
+ * @brief set callback, which is called for every state-transition of the circuit-breaker for
+ *        requests to misaki
+ *
+ * @param callback new callback
+ */
+void
+setMisakiCircuitStateCallback(const CircuitStateCallback &callback)
+{
+    MisakiCallGuard::getInstance()->getCircuitBreaker()->setStateCallback(callback);
+}
+
+/**
+ * @brief set time before the expiration of an internal token, where the cached token is not
+ *        handed out anymore and a new one is requested from misaki
+ *
+ * @param seconds safety-margin in seconds
+ */
+void
+setInternalTokenSafetyMargin(const uint32_t seconds)
+{
+    TokenCache::getInstance()->setSafetyMargin(seconds);
+}
+
+/**
+ * @brief start a background-thread, which renews all cached internal tokens before they expire,
+ *        so getInternalToken doesn't have to block on a request to misaki anymore
+ *
+ * @param refreshMargin time in seconds before the expiration of a token, where it is renewed
+ *
+ * @return false, if refresher is already running or can not be started, else true
+ */
+bool
+initInternalTokenRefresher(const uint32_t refreshMargin)
+{
+    return TokenRefresher::getInstance()->startRefresh(refreshMargin);
+}
+
+/**
+ * @brief remove all cached internal tokens
+ */
+void
+clearInternalTokenCache()
+{
+    TokenCache::getInstance()->clear();
+}
+
+/**
+ * @brief init the local validation of jwt-tokens
+ *
+ * @param tokenKey key, which was used by misaki to sign the tokens
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+initTokenValidation(const std::string &tokenKey,
+                    Kitsunemimi::ErrorContainer &error)
+{
+    return TokenValidator::getInstance()->setKey(tokenKey, error);
+}
+
+/**
+ * @brief init the local validation of jwt-tokens with keys from a file. The file contains
+ *        either a single key or a json-object with the form
+ *        {"keys": [{"kid": "<ID>", "key": "<SECRET>"}, ...]}, where the key is selected by the
+ *        kid-header of the token.
+ *
+ * @param keyFilePath path to the key-file
+ * @param watchFile true to reload the keys, every time the file was changed
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+initTokenValidationFromFile(const std::string &keyFilePath,
+                            const bool watchFile,
+                            Kitsunemimi::ErrorContainer &error)
+{
+    if(watchFile) {
+        return KeyStore::getInstance()->startWatching(keyFilePath, error);
+    }
+
+    return KeyStore::getInstance()->loadFromFile(keyFilePath, error);
+}
+
+/**
+ * @brief init the local validation of jwt-tokens with the keys of misaki
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+initTokenValidationFromMisaki(Kitsunemimi::ErrorContainer &error)
+{
+    return KeyStore::getInstance()->loadFromMisaki(error);
+}
+
+/**
+ * @brief load the revoked tokens from misaki and pull their changes periodically, so revoked
+ *        tokens are also rejected by the local validation
+ *
+ * @param pullIntervalSec time in seconds between two requests to misaki (1 - 86400)
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+initTokenRevocation(const uint32_t pullIntervalSec,
+                    Kitsunemimi::ErrorContainer &error)
+{
+    return RevocationFilter::getInstance()->startPulling(pullIntervalSec, error);
+}
+
+/**
+ * @brief apply changes of the revoked tokens, which were pushed by misaki
+ *
+ * @param deltaJson delta with the form
+ *                  {"version": <N>, "base_version": <N>, "full": <BOOL>, "revoked": [<IDs>],
+ *                  "unrevoked": [<IDs>]}, where base_version is optional and defaults to
+ *                  version - 1
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+updateTokenRevocations(const std::string &deltaJson,
+                       Kitsunemimi::ErrorContainer &error)
+{
+    return RevocationFilter::getInstance()->applyDelta(deltaJson, error);
+}
+
+/**
+ * @brief validate a jwt-token in-process, without a request to misaki. Checks the signature,
+ *        the expiration and the required claims of the token.
+ *
+ * @param claims reference for the claims of the token
+ * @param token jwt-token to validate
+ * @param error reference for error-output
+ *
+ * @return true, if the token is valid, else false
+ */
+bool
+validateToken(TokenClaims &claims,
+              const std::string &token,
+              Kitsunemimi::ErrorContainer &error)
+{
+    TokenClaimsPtr sharedClaims;
+    if(TokenValidator::getInstance()->validate(sharedClaims, token, error) == false) {
         return false;
     }
 
+    claims = *sharedClaims;
+
     return true;
 }
 
+/**
+ * @brief validate a jwt-token in-process like the other validateToken, but without copying
+ *        the claims. The claims are shared with the cache of verified tokens and must not be
+ *        changed.
+ *
+ * @param claims reference for the shared claims of the token
+ * @param token jwt-token to validate
+ * @param error reference for error-output
+ *
+ * @return true, if the token is valid, else false
+ */
+bool
+validateToken(TokenClaimsPtr &claims,
+              const std::string &token,
+              Kitsunemimi::ErrorContainer &error)
+{
+    return TokenValidator::getInstance()->validate(claims, token, error);
+}
+
+/**
+ * @brief set maximum number of tokens in the cache of already validated tokens
+ *
+ * @param maxNumberOfTokens new maximum. 0 disables the cache.
+ */
+void
+setVerifiedTokenCacheSize(const uint64_t maxNumberOfTokens)
+{
+    VerifiedTokenCache::getInstance()->setMaxNumberOfEntries(maxNumberOfTokens);
+}
+
+/**
+ * @brief get hit-, miss- and eviction-counter of the cache of already validated tokens
+ *
+ * @param stats reference for the resulting counters
+ */
+void
+getVerifiedTokenCacheStats(VerifiedTokenCacheStats &stats)
+{
+    VerifiedTokenCache::getInstance()->getStats(stats);
+}
+
+/**
+ * @brief check if a token has access to an endpoint of the local component. Decisions are
+ *        cached per role-set (or per token, if local validation is not initialized), endpoint
+ *        and http-type, so repeated checks are answered in-process.
+ *
+ * @param isAllowed reference for the decision
+ * @param token jwt-token of the request
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param error reference for error-output
+ *
+ * @return false, if the decision could not be made, else true
+ */
+bool
+checkPermission(bool &isAllowed,
+                const std::string &token,
+                const std::string &endpoint,
+                const Kitsunemimi::Hanami::HttpRequestType httpType,
+                Kitsunemimi::ErrorContainer &error)
+{
+    return checkAccess(isAllowed, token, endpoint, httpType, error);
+}
+
+/**
+ * @brief set time, how long decisions of misaki are cached
+ *
+ * @param seconds time-to-live in seconds
+ */
+void
+setPermissionCacheTtl(const uint32_t seconds)
+{
+    PermissionCache::getInstance()->setTtl(seconds);
+}
+
+/**
+ * @brief remove all cached decisions, for example after the policy was changed
+ */
+void
+invalidatePermissionCache()
+{
+    PermissionCache::getInstance()->invalidate();
+}
+
+/**
+ * @brief remove all cached decisions for an endpoint
+ *
+ * @param endpoint endpoint, whose decisions should be removed
+ */
+void
+invalidatePermissionCacheForEndpoint(const std::string &endpoint)
+{
+    PermissionCache::getInstance()->invalidateEndpoint(endpoint);
+}
+
+/**
+ * @brief download the policy of the local component from misaki and compile it against the
+ *        registered endpoints, so checkPermission can decide in-process. Must be called after
+ *        all endpoints of the component are registered.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+initPolicy(Kitsunemimi::ErrorContainer &error)
+{
+    return PolicyStore::getInstance()->loadFromMisaki(error);
+}
+
+/**
+ * @brief replace the compiled policy without blocking running permission-checks
+ *
+ * @param policyJson policy with the form {"policy": {"<endpoint>": {"<HTTP-TYPE>": [<roles>]}}}
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+updatePolicy(const std::string &policyJson,
+             Kitsunemimi::ErrorContainer &error)
+{
+    return PolicyStore::getInstance()->update(policyJson, error);
+}
+
+/**
+ * @brief compile the input-validation of all registered endpoints again and update the
+ *        version of the endpoint-registry, which is used by the api-documentation. Must be
+ *        called, when endpoints or blossoms were added after initMisakiBlossoms.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+initRequestValidators(Kitsunemimi::ErrorContainer &error)
+{
+    ApiDocuCache::getInstance()->updateRegistryVersion();
+    return RequestValidatorStore::getInstance()->build(error);
+}
+
+/**
+ * @brief check the input of a request with the precompiled validator of the endpoint, without
+ *        compiling regexes or searching the validation-map of the blossom
+ *
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param input input-values of the request
+ * @param error reference for error-output
+ *
+ * @return true, if the input is valid, else false
+ */
+bool
+checkRequestInput(const std::string &endpoint,
+                  const Kitsunemimi::Hanami::HttpRequestType httpType,
+                  const Kitsunemimi::DataMap &input,
+                  Kitsunemimi::ErrorContainer &error)
+{
+    return RequestValidatorStore::getInstance()->validate(endpoint, httpType, input, error);
+}
+
 }
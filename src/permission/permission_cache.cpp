@@ -0,0 +1,227 @@
+/**
+ * @file        permission_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <permission/permission_cache.h>
+#include <token/jwt_helper.h>
+
+#include <mutex>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+PermissionCache::PermissionCache()
+{
+    m_generation = 0;
+    m_ttl = 60;
+}
+
+/**
+ * @brief get instance of the permission-cache
+ *
+ * @return pointer to the static instance
+ */
+PermissionCache*
+PermissionCache::getInstance()
+{
+    static PermissionCache instance;
+    return &instance;
+}
+
+/**
+ * @brief get cached decision for a request
+ *
+ * @param isAllowed reference for the cached decision
+ * @param principal identifier of the requesting user or role-set
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ *
+ * @return true, if a not expired decision was found, else false
+ */
+bool
+PermissionCache::get(bool &isAllowed,
+                     const std::string &principal,
+                     const std::string &endpoint,
+                     const Hanami::HttpRequestType httpType)
+{
+    const std::string key = createKey(principal, endpoint, httpType);
+    const long now = getCurrentUnixTime();
+
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+
+    const auto it = m_entries.find(key);
+    if(it == m_entries.end()
+            || it->second.expireTime <= now)
+    {
+        return false;
+    }
+
+    isAllowed = it->second.isAllowed;
+
+    return true;
+}
+
+/**
+ * @brief add a decision to the cache
+ *
+ * @param principal identifier of the requesting user or role-set
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param isAllowed decision of misaki
+ * @param generation generation of the cache, at the time when the decision was requested. If
+ *                   the cache was invalidated in the meantime, the decision is dropped.
+ */
+void
+PermissionCache::add(const std::string &principal,
+                     const std::string &endpoint,
+                     const Hanami::HttpRequestType httpType,
+                     const bool isAllowed,
+                     const uint64_t generation)
+{
+    CacheEntry entry;
+    entry.principal = principal;
+    entry.endpoint = endpoint;
+    entry.isAllowed = isAllowed;
+    entry.expireTime = getCurrentUnixTime() + static_cast<long>(m_ttl.load());
+
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+
+    if(generation != m_generation) {
+        return;
+    }
+
+    // existing entries are only refreshed and keep their position in the insertion-order
+    const std::string key = createKey(principal, endpoint, httpType);
+    const auto it = m_entries.find(key);
+    if(it != m_entries.end())
+    {
+        it->second = entry;
+        return;
+    }
+
+    // all entries have the same ttl, so the oldest entries are the first, which expire. They
+    // are dropped first and if the cache is still full, the oldest valid entry is evicted.
+    const long now = getCurrentUnixTime();
+    while(m_insertionOrder.size() > 0)
+    {
+        const auto oldest = m_entries.find(m_insertionOrder.front());
+        if(oldest->second.expireTime > now
+                && m_entries.size() < MAX_NUMBER_OF_ENTRIES)
+        {
+            break;
+        }
+
+        m_entries.erase(oldest);
+        m_insertionOrder.pop_front();
+    }
+
+    m_entries.emplace(key, entry);
+    m_insertionOrder.push_back(key);
+}
+
+/**
+ * @brief get actual generation of the cache, which is increased by every invalidation
+ */
+uint64_t
+PermissionCache::getGeneration() const
+{
+    return m_generation;
+}
+
+/**
+ * @brief set time, how long a decision is cached
+ *
+ * @param seconds time-to-live in seconds
+ */
+void
+PermissionCache::setTtl(const uint32_t seconds)
+{
+    m_ttl = seconds;
+}
+
+/**
+ * @brief remove all cached decisions
+ */
+void
+PermissionCache::invalidate()
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+    m_generation++;
+    m_entries.clear();
+    m_insertionOrder.clear();
+}
+
+/**
+ * @brief remove all cached decisions for an endpoint
+ *
+ * @param endpoint endpoint, whose decisions should be removed
+ */
+void
+PermissionCache::invalidateEndpoint(const std::string &endpoint)
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+    m_generation++;
+
+    for(auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if(it->second.endpoint == endpoint) {
+            it = m_entries.erase(it);
+        } else {
+            it++;
+        }
+    }
+
+    // keep the insertion-order in sync with the remaining entries
+    std::deque<std::string> insertionOrder;
+    for(const std::string &key : m_insertionOrder)
+    {
+        if(m_entries.find(key) != m_entries.end()) {
+            insertionOrder.push_back(key);
+        }
+    }
+    m_insertionOrder.swap(insertionOrder);
+}
+
+/**
+ * @brief create key for the map of the cache
+ */
+const std::string
+PermissionCache::createKey(const std::string &principal,
+                           const std::string &endpoint,
+                           const Hanami::HttpRequestType httpType)
+{
+    std::string key;
+    key.reserve(principal.size() + endpoint.size() + 4);
+    key.append(principal);
+    key.push_back('\n');
+    key.append(endpoint);
+    key.push_back('\n');
+    key.append(std::to_string(static_cast<int>(httpType)));
+
+    return key;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,84 @@
+/**
+ * @file        permission_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_PERMISSION_CACHE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_PERMISSION_CACHE_H
+
+#include <string>
+#include <atomic>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+namespace Misaki
+{
+
+class PermissionCache
+{
+public:
+    static PermissionCache* getInstance();
+
+    static const uint64_t MAX_NUMBER_OF_ENTRIES = 100000;
+
+    bool get(bool &isAllowed,
+             const std::string &principal,
+             const std::string &endpoint,
+             const Kitsunemimi::Hanami::HttpRequestType httpType);
+    void add(const std::string &principal,
+             const std::string &endpoint,
+             const Kitsunemimi::Hanami::HttpRequestType httpType,
+             const bool isAllowed,
+             const uint64_t generation);
+
+    uint64_t getGeneration() const;
+    void setTtl(const uint32_t seconds);
+
+    void invalidate();
+    void invalidateEndpoint(const std::string &endpoint);
+
+private:
+    PermissionCache();
+
+    struct CacheEntry
+    {
+        std::string principal = "";
+        std::string endpoint = "";
+        bool isAllowed = false;
+        long expireTime = 0;
+    };
+
+    std::unordered_map<std::string, CacheEntry> m_entries;
+    std::deque<std::string> m_insertionOrder;
+    mutable std::shared_mutex m_lock;
+    std::atomic<uint64_t> m_generation;
+    std::atomic<uint32_t> m_ttl;
+
+    static const std::string createKey(const std::string &principal,
+                                       const std::string &endpoint,
+                                       const Kitsunemimi::Hanami::HttpRequestType httpType);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_PERMISSION_CACHE_H
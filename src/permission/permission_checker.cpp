@@ -0,0 +1,155 @@
+/**
+ * @file        permission_checker.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <permission/permission_checker.h>
+#include <permission/permission_cache.h>
+#include <permission/permission_request.h>
+#include <permission/policy_store.h>
+#include <validation/token_validator.h>
+#include <metrics/guard_metrics.h>
+
+#include <algorithm>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief get principal of a token, which is used as key for cached decisions
+ *
+ * @param principal reference for the resulting principal
+ * @param claims reference for the claims, if the token was locally validated
+ * @param isValid reference, which is set to false, if the token was locally rejected
+ * @param token jwt-token of the request
+ *
+ * @return true, if the token was locally validated, else false
+ */
+static bool
+getPrincipal(std::string &principal,
+             TokenClaimsPtr &claims,
+             bool &isValid,
+             const std::string &token)
+{
+    isValid = true;
+
+    // without local validation, every token is its own principal
+    TokenValidator* validator = TokenValidator::getInstance();
+    if(validator->isInitialized() == false)
+    {
+        principal = "token:" + token;
+        return false;
+    }
+
+    ErrorContainer error;
+    if(validator->validate(claims, token, error) == false)
+    {
+        isValid = false;
+        return true;
+    }
+
+    // decisions only depend on the roles, so all users with the same roles share the entries
+    std::vector<std::string> roles = claims->roles;
+    std::sort(roles.begin(), roles.end());
+
+    principal = "roles:";
+    if(claims->isAdmin) {
+        principal.append("*admin*");
+    }
+    for(const std::string &role : roles)
+    {
+        principal.push_back(',');
+        principal.append(role);
+    }
+
+    return true;
+}
+
+/**
+ * @brief check if a token has access to an endpoint of the local component. If the token can
+ *        be validated locally and the policy was loaded, the check is done completely
+ *        in-process. Otherwise decisions of misaki are cached, so repeated checks are answered
+ *        without a request to misaki.
+ *
+ * @param isAllowed reference for the decision
+ * @param token jwt-token of the request
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param error reference for error-output
+ *
+ * @return false, if the decision could not be made, else true
+ */
+bool
+checkAccess(bool &isAllowed,
+            const std::string &token,
+            const std::string &endpoint,
+            const Hanami::HttpRequestType httpType,
+            ErrorContainer &error)
+{
+    PermissionCache* cache = PermissionCache::getInstance();
+
+    // tokens, which are invalid, are rejected without asking misaki
+    bool isValid = false;
+    std::string principal;
+    TokenClaimsPtr claims;
+    const bool isLocallyValidated = getPrincipal(principal, claims, isValid, token);
+    if(isValid == false)
+    {
+        isAllowed = false;
+        return true;
+    }
+
+    // check against the compiled policy
+    if(isLocallyValidated
+            && PolicyStore::getInstance()->check(isAllowed, *claims, endpoint, httpType))
+    {
+        return true;
+    }
+
+    if(cache->get(isAllowed, principal, endpoint, httpType))
+    {
+        GuardMetrics::increaseCounter(PERMISSION_CACHE_HIT_COUNTER);
+        return true;
+    }
+    GuardMetrics::increaseCounter(PERMISSION_CACHE_MISS_COUNTER);
+
+    // the messaging-thread of the request is blocked by the check, so retries and backoff are
+    // limited by the deadline like the requests of internal tokens
+    const uint64_t generation = cache->getGeneration();
+    MisakiCallGuard* callGuard = MisakiCallGuard::getInstance();
+    const MisakiCallResult callResult = callGuard->call(
+                [&isAllowed, &token, &endpoint, httpType](ErrorContainer &callError)
+    {
+        return requestPermission(isAllowed, token, endpoint, httpType, callError);
+    },
+    callGuard->getDeadline(),
+    error);
+    if(callResult != MISAKI_CALL_OK) {
+        return false;
+    }
+
+    cache->add(principal, endpoint, httpType, isAllowed, generation);
+
+    return true;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,111 @@
+/**
+ * @file        permission_request.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <permission/permission_request.h>
+#include <token/token_message.h>
+
+#include <libKitsunemimiHanamiCommon/component_support.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+using Kitsunemimi::Hanami::HanamiMessagingClient;
+using Kitsunemimi::Hanami::HanamiMessaging;
+using Kitsunemimi::Hanami::SupportedComponents;
+
+namespace Misaki
+{
+
+/**
+ * @brief ask misaki, if a token has access to an endpoint of the local component
+ *
+ * @param isAllowed reference for the decision of misaki
+ * @param token jwt-token of the request
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param error reference for error-output
+ *
+ * @return MISAKI_CALL_OK, if misaki allowed or explicitly denied the access,
+ *         MISAKI_CALL_UNREACHABLE, if misaki could not be asked or failed internally,
+ *         else MISAKI_CALL_REJECTED
+ */
+MisakiCallResult
+requestPermission(bool &isAllowed,
+                  const std::string &token,
+                  const std::string &endpoint,
+                  const Kitsunemimi::Hanami::HttpRequestType httpType,
+                  Kitsunemimi::ErrorContainer &error)
+{
+    HanamiMessagingClient* misakiClient = HanamiMessaging::getInstance()->misakiClient;
+    Kitsunemimi::Hanami::ResponseMessage response;
+
+    // create request
+    Kitsunemimi::Hanami::RequestMessage request;
+    request.id = "v1/auth";
+    request.httpType = Kitsunemimi::Hanami::GET_TYPE;
+
+    std::string &body = request.inputValues;
+    body.clear();
+    body.append("{\"token\":\"");
+    appendJsonEscaped(body, token);
+    body.append("\",\"component\":\"");
+    appendJsonEscaped(body, SupportedComponents::getInstance()->localComponent);
+    body.append("\",\"endpoint\":\"");
+    appendJsonEscaped(body, endpoint);
+    body.append("\",\"http_type\":");
+    body.append(std::to_string(static_cast<int>(httpType)));
+    body.append("}");
+
+    // send request to misaki
+    if(misakiClient->triggerSakuraFile(response, request, error) == false)
+    {
+        error.addMeesage("Failed to trigger misaki to check permission for endpoint '"
+                         + endpoint + "'");
+        LOG_ERROR(error);
+        return MISAKI_CALL_UNREACHABLE;
+    }
+
+    if(response.success)
+    {
+        isAllowed = true;
+        return MISAKI_CALL_OK;
+    }
+
+    // only an explicit rejection is a decision, which can be cached. Every other error-response
+    // is a failure of misaki and must not lock out the users.
+    if(response.type == Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE
+            || response.type == Kitsunemimi::Hanami::FORBIDDEN_RTYPE)
+    {
+        isAllowed = false;
+        return MISAKI_CALL_OK;
+    }
+
+    error.addMeesage("Misaki failed to check permission for endpoint '" + endpoint
+                     + "' with status " + std::to_string(static_cast<int>(response.type)));
+    LOG_ERROR(error);
+    if(response.type >= Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE) {
+        return MISAKI_CALL_UNREACHABLE;
+    }
+
+    return MISAKI_CALL_REJECTED;
+}
+
+}  // namespace Misaki
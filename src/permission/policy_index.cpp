@@ -0,0 +1,354 @@
+/**
+ * @file        policy_index.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <permission/policy_index.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+PolicyIndex::PolicyIndex() {}
+
+/**
+ * @brief compile the policy against the endpoints of the local component
+ *
+ * @param policy policy with the form {"<endpoint>": {"<HTTP-TYPE>": ["<role>", ...]}}
+ * @param endpointRules registered endpoints of the local component
+ * @param error reference for error-output
+ *
+ * @return false, if the policy is invalid, else true
+ */
+bool
+PolicyIndex::build(JsonItem &policy,
+                   const EndpointRules &endpointRules,
+                   ErrorContainer &error)
+{
+    if(policy.isMap() == false)
+    {
+        error.addMeesage("Policy is not a json-object");
+        return false;
+    }
+
+    // assign ids to all roles first, to know the size of the bitsets
+    std::vector<std::string> endpoints;
+    for(const auto& [endpoint, rules] : endpointRules)
+    {
+        endpoints.push_back(endpoint);
+        if(policy.contains(endpoint) == false) {
+            continue;
+        }
+
+        JsonItem endpointPolicy = policy.get(endpoint);
+        for(const std::string &httpType : endpointPolicy.getKeys())
+        {
+            JsonItem roles = endpointPolicy.get(httpType);
+            for(uint64_t i = 0; i < roles.size(); i++) {
+                getRoleId(roles.get(i).getString());
+            }
+        }
+    }
+    m_numberOfWords = (m_roleIds.size() / 64) + 1;
+
+    // create bitsets for all endpoints, which are known by the local component
+    std::vector<int64_t> permissionPositions;
+    const std::vector<std::string> httpTypeNames = {"DELETE", "GET", "POST", "PUT"};
+    for(const std::string &endpoint : endpoints)
+    {
+        const int64_t pos = static_cast<int64_t>(m_permissions.size());
+        permissionPositions.push_back(pos);
+        m_permissions.resize(m_permissions.size() + httpTypeNames.size() * m_numberOfWords, 0);
+
+        if(policy.contains(endpoint) == false) {
+            continue;
+        }
+
+        JsonItem endpointPolicy = policy.get(endpoint);
+        for(uint64_t t = 0; t < httpTypeNames.size(); t++)
+        {
+            if(endpointPolicy.contains(httpTypeNames.at(t)) == false) {
+                continue;
+            }
+
+            JsonItem roles = endpointPolicy.get(httpTypeNames.at(t));
+            for(uint64_t i = 0; i < roles.size(); i++)
+            {
+                const uint32_t roleId = getRoleId(roles.get(i).getString());
+                uint64_t* bitset = &m_permissions[pos + t * m_numberOfWords];
+                bitset[roleId / 64] |= 1ULL << (roleId % 64);
+            }
+        }
+    }
+
+    // endpoints from the map are already sorted, which is required to build the trie
+    m_nodes.clear();
+    m_edges.clear();
+    m_labels.clear();
+    buildNode(endpoints, 0, endpoints.size(), 0, permissionPositions);
+
+    return true;
+}
+
+/**
+ * @brief set version and digest of the policy. They are part of the index, so they are always
+ *        published together with the compiled policy. Must be called before publishing.
+ *
+ * @param version version of the policy, which is increased with every update
+ * @param digest digest of the policy-json
+ */
+void
+PolicyIndex::setVersion(const uint64_t version,
+                        const uint64_t digest)
+{
+    m_version = version;
+    m_digest = digest;
+}
+
+/**
+ * @brief get version of the policy
+ *
+ * @return version, which was set before publishing
+ */
+uint64_t
+PolicyIndex::getVersion() const
+{
+    return m_version;
+}
+
+/**
+ * @brief get digest of the policy
+ *
+ * @return digest, which was set before publishing
+ */
+uint64_t
+PolicyIndex::getDigest() const
+{
+    return m_digest;
+}
+
+/**
+ * @brief convert a list of role-names into a bitset for the checks. Roles, which don't appear
+ *        within the policy, are ignored.
+ *
+ * @param roleMask reference for the resulting bitset
+ * @param roles list of role-names
+ */
+void
+PolicyIndex::getRoleMask(std::vector<uint64_t> &roleMask,
+                         const std::vector<std::string> &roles) const
+{
+    roleMask.assign(m_numberOfWords, 0);
+    for(const std::string &role : roles)
+    {
+        const auto it = m_roleIds.find(role);
+        if(it != m_roleIds.end()) {
+            roleMask[it->second / 64] |= 1ULL << (it->second % 64);
+        }
+    }
+}
+
+/**
+ * @brief check if a set of roles has access to an endpoint
+ *
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param roleMask bitset of the roles, created by getRoleMask
+ *
+ * @return true, if at least one of the roles has access, else false
+ */
+bool
+PolicyIndex::isAllowed(const std::string &endpoint,
+                       const Hanami::HttpRequestType httpType,
+                       const std::vector<uint64_t> &roleMask) const
+{
+    const int32_t httpTypePos = getHttpTypePos(httpType);
+    if(httpTypePos < 0
+            || m_nodes.size() == 0
+            || roleMask.size() != m_numberOfWords)
+    {
+        return false;
+    }
+
+    // walk down the trie
+    const Node* node = &m_nodes[0];
+    uint64_t pos = 0;
+    while(pos < endpoint.size())
+    {
+        const Edge* nextEdge = nullptr;
+        for(uint32_t i = 0; i < node->numberOfEdges; i++)
+        {
+            const Edge* edge = &m_edges[node->firstEdge + i];
+            if(edge->firstChar == endpoint[pos])
+            {
+                nextEdge = edge;
+                break;
+            }
+        }
+
+        if(nextEdge == nullptr
+                || endpoint.compare(pos,
+                                    nextEdge->labelLength,
+                                    m_labels,
+                                    nextEdge->labelPos,
+                                    nextEdge->labelLength) != 0)
+        {
+            return false;
+        }
+
+        pos += nextEdge->labelLength;
+        node = &m_nodes[nextEdge->child];
+    }
+
+    if(node->permissionPos < 0) {
+        return false;
+    }
+
+    // compare role-bitsets
+    const uint64_t* bitset = &m_permissions[node->permissionPos + httpTypePos * m_numberOfWords];
+    for(uint64_t i = 0; i < m_numberOfWords; i++)
+    {
+        if((bitset[i] & roleMask[i]) != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief create a node of the radix-trie for a range of sorted endpoints, which all have the
+ *        same prefix of the length of depth
+ *
+ * @param endpoints sorted list of all endpoints
+ * @param begin first endpoint of the range
+ * @param end end of the range
+ * @param depth length of the common prefix
+ * @param permissionPositions position of the bitsets for each endpoint
+ *
+ * @return id of the new node
+ */
+uint32_t
+PolicyIndex::buildNode(const std::vector<std::string> &endpoints,
+                       const uint64_t begin,
+                       const uint64_t end,
+                       const uint64_t depth,
+                       const std::vector<int64_t> &permissionPositions)
+{
+    const uint32_t nodeId = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node());
+
+    uint64_t pos = begin;
+    if(pos < end
+            && endpoints.at(pos).size() == depth)
+    {
+        m_nodes[nodeId].permissionPos = permissionPositions.at(pos);
+        pos++;
+    }
+
+    // split remaining endpoints into groups with the same next character
+    std::vector<std::pair<uint64_t, uint64_t>> groups;
+    while(pos < end)
+    {
+        const char firstChar = endpoints.at(pos).at(depth);
+        uint64_t groupEnd = pos + 1;
+        while(groupEnd < end
+              && endpoints.at(groupEnd).at(depth) == firstChar)
+        {
+            groupEnd++;
+        }
+        groups.push_back(std::make_pair(pos, groupEnd));
+        pos = groupEnd;
+    }
+
+    // reserve continuous edges for the node, before the children add their own edges
+    const uint32_t firstEdge = static_cast<uint32_t>(m_edges.size());
+    m_nodes[nodeId].firstEdge = firstEdge;
+    m_nodes[nodeId].numberOfEdges = static_cast<uint32_t>(groups.size());
+    m_edges.resize(m_edges.size() + groups.size());
+
+    for(uint64_t i = 0; i < groups.size(); i++)
+    {
+        const uint64_t groupBegin = groups.at(i).first;
+        const uint64_t groupEnd = groups.at(i).second;
+
+        // because the endpoints are sorted, the common prefix of the group is the common
+        // prefix of the first and the last endpoint of the group
+        const std::string &first = endpoints.at(groupBegin);
+        const std::string &last = endpoints.at(groupEnd - 1);
+        uint64_t prefixEnd = depth + 1;
+        while(prefixEnd < first.size()
+              && prefixEnd < last.size()
+              && first.at(prefixEnd) == last.at(prefixEnd))
+        {
+            prefixEnd++;
+        }
+
+        Edge edge;
+        edge.firstChar = first.at(depth);
+        edge.labelPos = static_cast<uint32_t>(m_labels.size());
+        edge.labelLength = static_cast<uint32_t>(prefixEnd - depth);
+        m_labels.append(first, depth, prefixEnd - depth);
+
+        edge.child = buildNode(endpoints, groupBegin, groupEnd, prefixEnd, permissionPositions);
+        m_edges[firstEdge + i] = edge;
+    }
+
+    return nodeId;
+}
+
+/**
+ * @brief get id of a role or create a new one
+ */
+uint32_t
+PolicyIndex::getRoleId(const std::string &role)
+{
+    const auto it = m_roleIds.find(role);
+    if(it != m_roleIds.end()) {
+        return it->second;
+    }
+
+    const uint32_t newId = static_cast<uint32_t>(m_roleIds.size());
+    m_roleIds.emplace(role, newId);
+
+    return newId;
+}
+
+/**
+ * @brief get position of the bitset of a http-type within the bitsets of an endpoint
+ */
+int32_t
+PolicyIndex::getHttpTypePos(const Hanami::HttpRequestType httpType)
+{
+    switch(httpType)
+    {
+        case Hanami::DELETE_TYPE: return 0;
+        case Hanami::GET_TYPE:    return 1;
+        case Hanami::POST_TYPE:   return 2;
+        case Hanami::PUT_TYPE:    return 3;
+        default:                  return -1;
+    }
+}
+
+}  // namespace Misaki
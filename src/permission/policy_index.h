@@ -0,0 +1,102 @@
+/**
+ * @file        policy_index.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_POLICY_INDEX_H
+#define KITSUNEMIMI_HANAMI_MISAKI_POLICY_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiJson/json_item.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+namespace Misaki
+{
+
+/**
+ * Compiled, immutable form of the policy of the local component. The endpoints are stored in a
+ * radix-trie over the endpoint-path and each endpoint has one role-bitset per http-type.
+ */
+class PolicyIndex
+{
+public:
+    typedef std::map<std::string,
+                     std::map<Kitsunemimi::Hanami::HttpRequestType,
+                              Kitsunemimi::Hanami::EndpointEntry>> EndpointRules;
+
+    PolicyIndex();
+
+    bool build(Kitsunemimi::JsonItem &policy,
+               const EndpointRules &endpointRules,
+               Kitsunemimi::ErrorContainer &error);
+
+    void setVersion(const uint64_t version,
+                    const uint64_t digest);
+    uint64_t getVersion() const;
+    uint64_t getDigest() const;
+
+    void getRoleMask(std::vector<uint64_t> &roleMask,
+                     const std::vector<std::string> &roles) const;
+    bool isAllowed(const std::string &endpoint,
+                   const Kitsunemimi::Hanami::HttpRequestType httpType,
+                   const std::vector<uint64_t> &roleMask) const;
+
+private:
+    struct Node
+    {
+        uint32_t firstEdge = 0;
+        uint32_t numberOfEdges = 0;
+        int64_t permissionPos = -1;
+    };
+
+    struct Edge
+    {
+        char firstChar = 0;
+        uint32_t labelPos = 0;
+        uint32_t labelLength = 0;
+        uint32_t child = 0;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges;
+    std::string m_labels;
+    std::vector<uint64_t> m_permissions;
+    std::unordered_map<std::string, uint32_t> m_roleIds;
+    uint64_t m_numberOfWords = 1;
+    uint64_t m_version = 0;
+    uint64_t m_digest = 0;
+
+    uint32_t buildNode(const std::vector<std::string> &endpoints,
+                       const uint64_t begin,
+                       const uint64_t end,
+                       const uint64_t depth,
+                       const std::vector<int64_t> &permissionPositions);
+    uint32_t getRoleId(const std::string &role);
+    static int32_t getHttpTypePos(const Kitsunemimi::Hanami::HttpRequestType httpType);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_POLICY_INDEX_H
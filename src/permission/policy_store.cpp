@@ -0,0 +1,233 @@
+/**
+ * @file        policy_store.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <permission/policy_store.h>
+#include <permission/permission_cache.h>
+#include <token/token_message.h>
+#include <common/digest.h>
+
+#include <libKitsunemimiHanamiCommon/component_support.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessagingClient;
+using Kitsunemimi::Hanami::HanamiMessaging;
+using Kitsunemimi::Hanami::SupportedComponents;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+PolicyStore::PolicyStore() {}
+
+/**
+ * @brief get instance of the policy-store
+ *
+ * @return pointer to the static instance
+ */
+PolicyStore*
+PolicyStore::getInstance()
+{
+    static PolicyStore instance;
+    return &instance;
+}
+
+/**
+ * @brief download the policy of the local component from misaki and compile it
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PolicyStore::loadFromMisaki(ErrorContainer &error)
+{
+    HanamiMessagingClient* misakiClient = HanamiMessaging::getInstance()->misakiClient;
+    Hanami::ResponseMessage response;
+
+    // create request
+    Hanami::RequestMessage request;
+    request.id = "v1/policy";
+    request.httpType = Hanami::GET_TYPE;
+    request.inputValues = "{\"component\":\"";
+    appendJsonEscaped(request.inputValues, SupportedComponents::getInstance()->localComponent);
+    request.inputValues.append("\"}");
+
+    // request policy from misaki
+    if(misakiClient->triggerSakuraFile(response, request, error) == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get the policy");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // check response
+    if(response.success == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get the policy (no success)");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    return update(response.responseContent, error);
+}
+
+/**
+ * @brief compile a new policy and replace the old one without blocking running checks
+ *
+ * @param policyJson policy with the form {"policy": {"<endpoint>": {"<HTTP-TYPE>": [<roles>]}}}
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PolicyStore::update(const std::string &policyJson,
+                    ErrorContainer &error)
+{
+    JsonItem parsedPolicy;
+    if(parsedPolicy.parse(policyJson, error) == false)
+    {
+        error.addMeesage("Failed to parse policy");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    JsonItem policy = parsedPolicy;
+    if(parsedPolicy.contains("policy")) {
+        policy = parsedPolicy.get("policy");
+    }
+
+    // version and digest are published together with the index, so a reader never gets the
+    // digest of one policy and the index of another one
+    std::lock_guard<std::mutex> guard(m_updateLock);
+
+    PolicyIndex* newIndex = new PolicyIndex();
+    if(newIndex->build(policy, HanamiMessaging::getInstance()->endpointRules, error) == false)
+    {
+        delete newIndex;
+        error.addMeesage("Failed to compile policy");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    newIndex->setVersion(getVersion() + 1, calcDigest(policyJson));
+    m_index.publish(newIndex);
+
+    // decisions of misaki, which are based on the old policy, are not valid anymore
+    PermissionCache::getInstance()->invalidate();
+
+    return true;
+}
+
+/**
+ * @brief check if a policy was loaded
+ *
+ * @return true, if loaded, else false
+ */
+bool
+PolicyStore::isLoaded() const
+{
+    return m_index.read().get() != nullptr;
+}
+
+/**
+ * @brief get version of the policy, which is increased with every update
+ *
+ * @return version of the policy
+ */
+uint64_t
+PolicyStore::getVersion() const
+{
+    const RcuPointer<PolicyIndex>::ReadGuard index = m_index.read();
+    if(index.get() == nullptr) {
+        return 0;
+    }
+
+    return index->getVersion();
+}
+
+/**
+ * @brief get digest of the actual policy, which is the same for the same policy, also after a
+ *        restart
+ *
+ * @return digest of the policy
+ */
+uint64_t
+PolicyStore::getDigest() const
+{
+    const RcuPointer<PolicyIndex>::ReadGuard index = m_index.read();
+    if(index.get() == nullptr) {
+        return 0;
+    }
+
+    return index->getDigest();
+}
+
+/**
+ * @brief get read-access to the compiled policy, which stays valid until the guard is destroyed
+ *
+ * @return guard with the compiled policy, or with nullptr if no policy is loaded
+ */
+RcuPointer<PolicyIndex>::ReadGuard
+PolicyStore::readIndex() const
+{
+    return m_index.read();
+}
+
+/**
+ * @brief check access of a validated token against the compiled policy
+ *
+ * @param isAllowed reference for the decision
+ * @param claims claims of the validated token
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ *
+ * @return false, if no policy is loaded, else true
+ */
+bool
+PolicyStore::check(bool &isAllowed,
+                   const TokenClaims &claims,
+                   const std::string &endpoint,
+                   const Hanami::HttpRequestType httpType) const
+{
+    const RcuPointer<PolicyIndex>::ReadGuard index = m_index.read();
+    if(index.get() == nullptr) {
+        return false;
+    }
+
+    if(claims.isAdmin)
+    {
+        isAllowed = true;
+        return true;
+    }
+
+    std::vector<uint64_t> roleMask;
+    index->getRoleMask(roleMask, claims.roles);
+    isAllowed = index->isAllowed(endpoint, httpType, roleMask);
+
+    return true;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,63 @@
+/**
+ * @file        policy_store.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_POLICY_STORE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_POLICY_STORE_H
+
+#include <string>
+#include <mutex>
+
+#include <common/rcu_pointer.h>
+#include <permission/policy_index.h>
+#include <libMisakiGuard/misaki_input.h>
+
+namespace Misaki
+{
+
+class PolicyStore
+{
+public:
+    static PolicyStore* getInstance();
+
+    bool loadFromMisaki(Kitsunemimi::ErrorContainer &error);
+    bool update(const std::string &policyJson,
+                Kitsunemimi::ErrorContainer &error);
+
+    bool isLoaded() const;
+    uint64_t getVersion() const;
+    uint64_t getDigest() const;
+    RcuPointer<PolicyIndex>::ReadGuard readIndex() const;
+    bool check(bool &isAllowed,
+               const TokenClaims &claims,
+               const std::string &endpoint,
+               const Kitsunemimi::Hanami::HttpRequestType httpType) const;
+
+private:
+    PolicyStore();
+
+    RcuPointer<PolicyIndex> m_index;
+    std::mutex m_updateLock;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_POLICY_STORE_H
@@ -55,21 +55,81 @@ LIBS += -L../../libKitsunemimiHanamiNetwork/src/debug -lKitsunemimiHanamiNetwork
 LIBS += -L../../libKitsunemimiHanamiNetwork/src/release -lKitsunemimiHanamiNetwork
 INCLUDEPATH += ../../libKitsunemimiHanamiNetwork/include
 
-LIBS += -lssl -lcryptopp -lcrypto
+LIBS += -lssl -lcryptopp -lcrypto -lz -lzstd
 
 INCLUDEPATH += $$PWD \
                $$PWD/../include
 
 HEADERS += \
     ../include/libMisakiGuard/misaki_input.h \
+    common/base64.h \
+    common/circuit_breaker.h \
+    common/digest.h \
+    common/misaki_call_guard.h \
+    common/rcu_pointer.h \
+    common/worker_pool.h \
+    documentation/api_docu_cache.h \
+    documentation/docu_compression.h \
+    documentation/docu_filter.h \
+    documentation/docu_formats.h \
+    documentation/docu_job_queue.h \
+    documentation/docu_renderer.h \
+    documentation/docu_stream.h \
     generate_api_docu.h \
-    md_docu_generation.h \
-    rst_docu_generation.h
+    get_api_docu_job.h \
+    get_guard_metrics.h \
+    metrics/guard_metrics.h \
+    permission/permission_cache.h \
+    permission/permission_checker.h \
+    permission/permission_request.h \
+    permission/policy_index.h \
+    permission/policy_store.h \
+    token/jwt_helper.h \
+    token/token_cache.h \
+    token/token_fetcher.h \
+    token/token_message.h \
+    token/token_refresher.h \
+    token/token_request.h \
+    validation/key_file_watcher.h \
+    validation/key_store.h \
+    validation/request_validator.h \
+    validation/request_validator_store.h \
+    validation/revocation_filter.h \
+    validation/token_validator.h \
+    validation/verified_token_cache.h
 
 SOURCES += \
+    common/base64.cpp \
+    common/circuit_breaker.cpp \
+    common/misaki_call_guard.cpp \
+    common/worker_pool.cpp \
+    documentation/api_docu_cache.cpp \
+    documentation/docu_compression.cpp \
+    documentation/docu_job_queue.cpp \
+    documentation/docu_renderer.cpp \
+    documentation/docu_stream.cpp \
     generate_api_docu.cpp \
-    md_docu_generation.cpp \
+    get_api_docu_job.cpp \
+    get_guard_metrics.cpp \
+    metrics/guard_metrics.cpp \
     misaki_input.cpp \
-    rst_docu_generation.cpp
+    permission/permission_cache.cpp \
+    permission/permission_checker.cpp \
+    permission/permission_request.cpp \
+    permission/policy_index.cpp \
+    permission/policy_store.cpp \
+    token/jwt_helper.cpp \
+    token/token_cache.cpp \
+    token/token_fetcher.cpp \
+    token/token_message.cpp \
+    token/token_refresher.cpp \
+    token/token_request.cpp \
+    validation/key_file_watcher.cpp \
+    validation/key_store.cpp \
+    validation/request_validator.cpp \
+    validation/request_validator_store.cpp \
+    validation/revocation_filter.cpp \
+    validation/token_validator.cpp \
+    validation/verified_token_cache.cpp
 
 DISTFILES +=
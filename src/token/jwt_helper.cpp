@@ -0,0 +1,101 @@
+/**
+ * @file        jwt_helper.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <token/jwt_helper.h>
+#include <common/base64.h>
+
+#include <chrono>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief get current time in seconds since epoch, which is the same unit like the exp-claim
+ *
+ * @return current unix-time in seconds
+ */
+long
+getCurrentUnixTime()
+{
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::seconds>(now).count();
+}
+
+/**
+ * @brief decode a single part of a jwt-token WITHOUT validating its signature
+ *
+ * @param result reference for the parsed json-content of the part
+ * @param token jwt-token with the form <header>.<payload>.<signature>
+ * @param part part of the token, which should be decoded
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+parseJwtPart(JsonItem &result,
+             const std::string &token,
+             const JwtPart part,
+             ErrorContainer &error)
+{
+    // get position of the requested part within the token
+    const size_t firstDot = token.find('.');
+    if(firstDot == std::string::npos)
+    {
+        error.addMeesage("Jwt-token has an invalid format");
+        return false;
+    }
+    const size_t secondDot = token.find('.', firstDot + 1);
+    if(secondDot == std::string::npos)
+    {
+        error.addMeesage("Jwt-token has an invalid format");
+        return false;
+    }
+
+    uint64_t partStart = 0;
+    uint64_t partSize = firstDot;
+    if(part == JWT_PAYLOAD_PART)
+    {
+        partStart = firstDot + 1;
+        partSize = secondDot - firstDot - 1;
+    }
+
+    // decode base64url-content directly from the token
+    std::string decodedString;
+    if(appendDecodedBase64(decodedString, &token[partStart], partSize, BASE64_URL) == false)
+    {
+        error.addMeesage("Failed to decode base64-content of jwt-token");
+        return false;
+    }
+
+    // parse content of the part
+    if(result.parse(decodedString, error) == false)
+    {
+        error.addMeesage("Failed to parse json-content of jwt-token");
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace Misaki
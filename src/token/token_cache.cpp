@@ -0,0 +1,248 @@
+/**
+ * @file        token_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <token/token_cache.h>
+#include <token/jwt_helper.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+TokenCache::TokenCache()
+    : m_entries(new EntryMap())
+{
+    m_safetyMargin = 60;
+}
+
+/**
+ * @brief get instance of the token-cache
+ *
+ * @return pointer to the static instance
+ */
+TokenCache*
+TokenCache::getInstance()
+{
+    static TokenCache instance;
+    return &instance;
+}
+
+/**
+ * @brief get cached token of a component, which is still valid longer than the safety-margin
+ *
+ * @param token reference for the resulting token
+ * @param componentName name of the component where the token is for
+ *
+ * @return true, if a token was found, which is valid longer than the safety-margin, else false
+ */
+bool
+TokenCache::getToken(std::string &token,
+                     const std::string &componentName)
+{
+    return getValidToken(token, componentName, static_cast<long>(m_safetyMargin.load()));
+}
+
+/**
+ * @brief get cached token of a component, which is not expired yet. Unlike getToken, the
+ *        token is also returned within the safety-margin before its expiration, so it can
+ *        still be used while its refresh is running.
+ *
+ * @param token reference for the resulting token
+ * @param componentName name of the component where the token is for
+ *
+ * @return true, if a token was found, which is not expired, else false
+ */
+bool
+TokenCache::getUnexpiredToken(std::string &token,
+                              const std::string &componentName)
+{
+    return getValidToken(token, componentName, 0);
+}
+
+/**
+ * @brief get names of all components, whose token expires within the given time-range
+ *
+ * @param componentNames reference for the resulting list of component-names
+ * @param refreshMargin time-range in seconds
+ */
+void
+TokenCache::getRefreshCandidates(std::vector<std::string> &componentNames,
+                                 const uint32_t refreshMargin)
+{
+    const long now = getCurrentUnixTime();
+    const RcuPointer<EntryMap>::ReadGuard entries = m_entries.read();
+
+    for(const auto& [componentName, entry] : *entries)
+    {
+        if(entry.expireTime - static_cast<long>(refreshMargin) <= now) {
+            componentNames.push_back(componentName);
+        }
+    }
+}
+
+/**
+ * @brief add or replace the token of a component
+ *
+ * @param componentName name of the component where the token is for
+ * @param token new jwt-token
+ * @param error reference for error-output
+ *
+ * @return false, if the exp-claim of the token can not be read, else true
+ */
+bool
+TokenCache::setToken(const std::string &componentName,
+                     const std::string &token,
+                     ErrorContainer &error)
+{
+    long expireTime = 0;
+    if(getExpireTime(expireTime, token, error) == false)
+    {
+        error.addMeesage("Failed to cache internal jwt-token of component '"
+                         + componentName + "'");
+        return false;
+    }
+
+    CacheEntry entry;
+    entry.token = token;
+    entry.expireTime = expireTime;
+
+    std::lock_guard<std::mutex> guard(m_writeLock);
+
+    EntryMap* newEntries = new EntryMap(*m_entries.read());
+    (*newEntries)[componentName] = entry;
+    m_entries.publish(newEntries);
+
+    return true;
+}
+
+/**
+ * @brief remove the cached token of a component
+ *
+ * @param componentName name of the component
+ */
+void
+TokenCache::removeToken(const std::string &componentName)
+{
+    std::lock_guard<std::mutex> guard(m_writeLock);
+
+    EntryMap* newEntries = new EntryMap(*m_entries.read());
+    newEntries->erase(componentName);
+    m_entries.publish(newEntries);
+}
+
+/**
+ * @brief remove all cached tokens
+ */
+void
+TokenCache::clear()
+{
+    std::lock_guard<std::mutex> guard(m_writeLock);
+    m_entries.publish(new EntryMap());
+}
+
+/**
+ * @brief set time before the expiration of a token, where it is not handed out anymore
+ *
+ * @param seconds safety-margin in seconds
+ */
+void
+TokenCache::setSafetyMargin(const uint32_t seconds)
+{
+    m_safetyMargin = seconds;
+}
+
+/**
+ * @brief get the actual safety-margin
+ *
+ * @return safety-margin in seconds
+ */
+uint32_t
+TokenCache::getSafetyMargin() const
+{
+    return m_safetyMargin;
+}
+
+/**
+ * @brief read the exp-claim of a jwt-token
+ *
+ * @param expireTime reference for the resulting expire-time in seconds since epoch
+ * @param token jwt-token to check
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+TokenCache::getExpireTime(long &expireTime,
+                          const std::string &token,
+                          ErrorContainer &error)
+{
+    JsonItem payload;
+    if(parseJwtPart(payload, token, JWT_PAYLOAD_PART, error) == false) {
+        return false;
+    }
+
+    if(payload.contains("exp") == false)
+    {
+        error.addMeesage("Jwt-token has no exp-claim");
+        return false;
+    }
+
+    expireTime = payload.get("exp").getLong();
+
+    return true;
+}
+
+/**
+ * @brief get cached token of a component without blocking
+ *
+ * @param token reference for the resulting token
+ * @param componentName name of the component where the token is for
+ * @param margin time in seconds, which the token has to be valid at least
+ *
+ * @return true, if a matching token was found, else false
+ */
+bool
+TokenCache::getValidToken(std::string &token,
+                          const std::string &componentName,
+                          const long margin)
+{
+    const long now = getCurrentUnixTime();
+    const RcuPointer<EntryMap>::ReadGuard entries = m_entries.read();
+
+    const auto it = entries->find(componentName);
+    if(it == entries->end()) {
+        return false;
+    }
+
+    if(it->second.expireTime - margin <= now) {
+        return false;
+    }
+
+    token = it->second.token;
+
+    return true;
+}
+
+}  // namespace Misaki
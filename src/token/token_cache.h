@@ -0,0 +1,84 @@
+/**
+ * @file        token_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_TOKEN_CACHE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_TOKEN_CACHE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+#include <common/rcu_pointer.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Misaki
+{
+
+class TokenCache
+{
+public:
+    static TokenCache* getInstance();
+
+    bool getToken(std::string &token,
+                  const std::string &componentName);
+    bool getUnexpiredToken(std::string &token,
+                           const std::string &componentName);
+    void getRefreshCandidates(std::vector<std::string> &componentNames,
+                              const uint32_t refreshMargin);
+    bool setToken(const std::string &componentName,
+                  const std::string &token,
+                  Kitsunemimi::ErrorContainer &error);
+    void removeToken(const std::string &componentName);
+    void clear();
+
+    void setSafetyMargin(const uint32_t seconds);
+    uint32_t getSafetyMargin() const;
+
+    static bool getExpireTime(long &expireTime,
+                              const std::string &token,
+                              Kitsunemimi::ErrorContainer &error);
+
+private:
+    TokenCache();
+
+    struct CacheEntry
+    {
+        std::string token = "";
+        long expireTime = 0;
+    };
+    typedef std::map<std::string, CacheEntry> EntryMap;
+
+    bool getValidToken(std::string &token,
+                       const std::string &componentName,
+                       const long margin);
+
+    RcuPointer<EntryMap> m_entries;
+    std::mutex m_writeLock;
+    std::atomic<uint32_t> m_safetyMargin;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_TOKEN_CACHE_H
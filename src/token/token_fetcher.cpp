@@ -0,0 +1,341 @@
+/**
+ * @file        token_fetcher.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <token/token_fetcher.h>
+#include <token/token_cache.h>
+#include <token/token_request.h>
+#include <metrics/guard_metrics.h>
+
+#include <exception>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+TokenFetcher::TokenFetcher()
+    : m_workers("Misaki_TokenFetcher", NUMBER_OF_WORKERS, MAX_PENDING_REQUESTS) {}
+
+/**
+ * @brief destructor
+ */
+TokenFetcher::~TokenFetcher()
+{
+    shutdown();
+}
+
+/**
+ * @brief get instance of the token-fetcher
+ *
+ * @return pointer to the static instance
+ */
+TokenFetcher*
+TokenFetcher::getInstance()
+{
+    static TokenFetcher instance;
+    return &instance;
+}
+
+/**
+ * @brief request a new internal token from misaki in the background. If there is already a
+ *        request for the same component in flight, no new request is send and the result of
+ *        the running request is used instead.
+ *
+ * @param componentName name of the component where the token is for
+ *
+ * @return future, which gets the result of the request
+ */
+std::shared_future<InternalTokenResult>
+TokenFetcher::fetch(const std::string &componentName)
+{
+    expireRequests();
+
+    bool isNew = false;
+    InFlightRequestPtr inFlightRequest;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        inFlightRequest = getInFlightRequest(isNew, componentName);
+    }
+
+    if(isNew) {
+        startRequest(componentName, inFlightRequest);
+    }
+
+    return inFlightRequest->future;
+}
+
+/**
+ * @brief request a new internal token from misaki in the background and call the callback
+ *        with the result. Requests for the same component are coalesced like in the
+ *        future-based variant.
+ *
+ * @param componentName name of the component where the token is for
+ * @param callback callback, which is called by a thread of the worker-pool with the result
+ */
+void
+TokenFetcher::fetch(const std::string &componentName,
+                    const InternalTokenCallback &callback)
+{
+    expireRequests();
+
+    bool isNew = false;
+    InFlightRequestPtr inFlightRequest;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        inFlightRequest = getInFlightRequest(isNew, componentName);
+        inFlightRequest->callbacks.push_back(callback);
+    }
+
+    if(isNew) {
+        startRequest(componentName, inFlightRequest);
+    }
+}
+
+/**
+ * @brief finish all requests, whose deadline was reached, with an error. A request to misaki,
+ *        which hangs, can not block the callers of the component forever this way. If it
+ *        returns later, its result is dropped.
+ */
+void
+TokenFetcher::expireRequests()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::map<std::string, InFlightRequestPtr> expiredRequests;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        for(auto it = m_inFlightRequests.begin(); it != m_inFlightRequests.end(); )
+        {
+            if(it->second->deadline <= now)
+            {
+                expiredRequests.emplace(it->first, it->second);
+                it = m_inFlightRequests.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    for(const auto& [componentName, inFlightRequest] : expiredRequests)
+    {
+        GuardMetrics::increaseCounter(TOKEN_FETCH_ERROR_COUNTER);
+
+        InternalTokenResult result;
+        result.error.addMeesage("Deadline for the request of a internal jwt-token for component '"
+                                + componentName + "' reached");
+        completeRequest(componentName, inFlightRequest, result);
+    }
+}
+
+/**
+ * @brief stop the worker-pool and wait for the running requests. Requests, which were not
+ *        started yet, are finished with an error, so no caller waits forever.
+ */
+void
+TokenFetcher::shutdown()
+{
+    m_workers.shutdown();
+
+    std::map<std::string, InFlightRequestPtr> remainingRequests;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        remainingRequests = m_inFlightRequests;
+    }
+
+    for(const auto& [componentName, inFlightRequest] : remainingRequests)
+    {
+        InternalTokenResult result;
+        result.error.addMeesage("Request of internal jwt-token for component '"
+                                + componentName + "' was aborted by shutdown");
+        finishRequest(componentName, inFlightRequest, result);
+    }
+}
+
+/**
+ * @brief get the running request for a component or create a new one, if there is none.
+ *        The lock must be held by the caller.
+ *
+ * @param isNew reference, which is set to true, if the request was created by this call and
+ *              has to be started by the caller
+ * @param componentName name of the component where the token is for
+ *
+ * @return pointer to the request
+ */
+TokenFetcher::InFlightRequestPtr
+TokenFetcher::getInFlightRequest(bool &isNew,
+                                 const std::string &componentName)
+{
+    const auto it = m_inFlightRequests.find(componentName);
+    if(it != m_inFlightRequests.end())
+    {
+        isNew = false;
+        return it->second;
+    }
+
+    InFlightRequestPtr inFlightRequest = std::make_shared<InFlightRequest>();
+    inFlightRequest->future = inFlightRequest->promise.get_future().share();
+    inFlightRequest->deadline = MisakiCallGuard::getInstance()->getDeadline();
+    m_inFlightRequests.emplace(componentName, inFlightRequest);
+    isNew = true;
+
+    return inFlightRequest;
+}
+
+/**
+ * @brief hand a new request to the worker-pool. If the queue of the pool is full, the request
+ *        is finished with an error immediately.
+ *
+ * @param componentName name of the component where the token is for
+ * @param inFlightRequest new request
+ */
+void
+TokenFetcher::startRequest(const std::string &componentName,
+                           const InFlightRequestPtr &inFlightRequest)
+{
+    const bool isQueued = m_workers.addTask([this, componentName, inFlightRequest]()
+    {
+        processRequest(componentName, inFlightRequest);
+    });
+    if(isQueued) {
+        return;
+    }
+
+    GuardMetrics::increaseCounter(TOKEN_FETCH_ERROR_COUNTER);
+
+    InternalTokenResult result;
+    result.error.addMeesage("Too many pending requests of internal jwt-tokens to request a "
+                            "token for component '" + componentName + "'");
+    finishRequest(componentName, inFlightRequest, result);
+}
+
+/**
+ * @brief send request to misaki, cache the new token and hand the result to all waiting callers
+ *
+ * @param componentName name of the component where the token is for
+ * @param inFlightRequest request, which is processed
+ */
+void
+TokenFetcher::processRequest(const std::string &componentName,
+                             const InFlightRequestPtr &inFlightRequest)
+{
+    InternalTokenResult result;
+    {
+        ScopedLatency latency(TOKEN_FETCH_LATENCY_NS);
+        const MisakiCallResult callResult = MisakiCallGuard::getInstance()->call(
+                    [&result, &componentName](ErrorContainer &error)
+        {
+            return requestInternalToken(result.token, componentName, error);
+        },
+        inFlightRequest->deadline,
+        result.error);
+        result.success = callResult == MISAKI_CALL_OK;
+    }
+
+    GuardMetrics::increaseCounter(TOKEN_FETCH_COUNTER);
+    if(result.success == false) {
+        GuardMetrics::increaseCounter(TOKEN_FETCH_ERROR_COUNTER);
+    }
+
+    // a token, which can not be cached, is still a valid result for the callers
+    if(result.success)
+    {
+        ErrorContainer cacheError;
+        if(TokenCache::getInstance()->setToken(componentName, result.token, cacheError) == false) {
+            LOG_ERROR(cacheError);
+        }
+    }
+
+    finishRequest(componentName, inFlightRequest, result);
+}
+
+/**
+ * @brief remove a request from the running requests and hand the result to all waiting
+ *        callers. A request, which was already finished or expired, is ignored.
+ *
+ * @param componentName name of the component where the token is for
+ * @param inFlightRequest request to finish
+ * @param result result of the request
+ */
+void
+TokenFetcher::finishRequest(const std::string &componentName,
+                            const InFlightRequestPtr &inFlightRequest,
+                            const InternalTokenResult &result)
+{
+    // after the request is removed from the map, no new callbacks can be added anymore
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const auto it = m_inFlightRequests.find(componentName);
+        if(it == m_inFlightRequests.end()
+                || it->second != inFlightRequest)
+        {
+            return;
+        }
+        m_inFlightRequests.erase(it);
+    }
+
+    completeRequest(componentName, inFlightRequest, result);
+}
+
+/**
+ * @brief hand the result of a request, which was already removed from the running requests,
+ *        to all waiting callers
+ *
+ * @param componentName name of the component where the token is for
+ * @param inFlightRequest finished request
+ * @param result result of the request
+ */
+void
+TokenFetcher::completeRequest(const std::string &componentName,
+                              const InFlightRequestPtr &inFlightRequest,
+                              const InternalTokenResult &result)
+{
+    inFlightRequest->promise.set_value(result);
+
+    // a failing callback must neither stop the other callbacks nor terminate the process
+    for(const InternalTokenCallback &callback : inFlightRequest->callbacks)
+    {
+        try
+        {
+            callback(result);
+        }
+        catch(const std::exception &e)
+        {
+            ErrorContainer error;
+            error.addMeesage("Callback for internal jwt-token of component '"
+                             + componentName + "' failed: " + e.what());
+            LOG_ERROR(error);
+        }
+        catch(...)
+        {
+            ErrorContainer error;
+            error.addMeesage("Callback for internal jwt-token of component '"
+                             + componentName + "' failed with unknown exception");
+            LOG_ERROR(error);
+        }
+    }
+}
+
+}  // namespace Misaki
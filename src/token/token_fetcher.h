@@ -0,0 +1,87 @@
+/**
+ * @file        token_fetcher.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_TOKEN_FETCHER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_TOKEN_FETCHER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <chrono>
+
+#include <common/worker_pool.h>
+#include <libMisakiGuard/misaki_input.h>
+
+namespace Misaki
+{
+
+class TokenFetcher
+{
+public:
+    static TokenFetcher* getInstance();
+    ~TokenFetcher();
+
+    static const uint32_t NUMBER_OF_WORKERS = 4;
+    static const uint32_t MAX_PENDING_REQUESTS = 1024;
+
+    std::shared_future<InternalTokenResult> fetch(const std::string &componentName);
+    void fetch(const std::string &componentName,
+               const InternalTokenCallback &callback);
+    void expireRequests();
+    void shutdown();
+
+private:
+    TokenFetcher();
+
+    struct InFlightRequest
+    {
+        std::promise<InternalTokenResult> promise;
+        std::shared_future<InternalTokenResult> future;
+        std::vector<InternalTokenCallback> callbacks;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    typedef std::shared_ptr<InFlightRequest> InFlightRequestPtr;
+
+    std::map<std::string, InFlightRequestPtr> m_inFlightRequests;
+    std::mutex m_lock;
+    WorkerPool m_workers;
+
+    InFlightRequestPtr getInFlightRequest(bool &isNew,
+                                          const std::string &componentName);
+    void startRequest(const std::string &componentName,
+                      const InFlightRequestPtr &inFlightRequest);
+    void processRequest(const std::string &componentName,
+                        const InFlightRequestPtr &inFlightRequest);
+    void finishRequest(const std::string &componentName,
+                       const InFlightRequestPtr &inFlightRequest,
+                       const InternalTokenResult &result);
+    void completeRequest(const std::string &componentName,
+                         const InFlightRequestPtr &inFlightRequest,
+                         const InternalTokenResult &result);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_TOKEN_FETCHER_H
@@ -0,0 +1,363 @@
+/**
+ * @file        token_message.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <token/token_message.h>
+#include <metrics/guard_metrics.h>
+
+#include <libKitsunemimiJson/json_item.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief append a string with json-escaping to another string
+ *
+ * @param output string, where the escaped input should be appended
+ * @param input string to escape
+ */
+void
+appendJsonEscaped(std::string &output,
+                  const std::string &input)
+{
+    const char* hexChars = "0123456789abcdef";
+
+    for(const char c : input)
+    {
+        switch(c)
+        {
+            case '"':  output.append("\\\""); break;
+            case '\\': output.append("\\\\"); break;
+            case '\n': output.append("\\n");  break;
+            case '\r': output.append("\\r");  break;
+            case '\t': output.append("\\t");  break;
+            case '\b': output.append("\\b");  break;
+            case '\f': output.append("\\f");  break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20)
+                {
+                    output.append("\\u00");
+                    output.push_back(hexChars[(c >> 4) & 0xF]);
+                    output.push_back(hexChars[c & 0xF]);
+                }
+                else
+                {
+                    output.push_back(c);
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief create body for the request of an internal token
+ *
+ * @param body reference for the resulting json-string
+ * @param componentName name of the component where the token is for
+ */
+void
+createTokenRequestBody(std::string &body,
+                       const std::string &componentName)
+{
+    const std::string prefix = "{\"service_name\":\"";
+
+    body.clear();
+    body.reserve(prefix.size() + componentName.size() + 2);
+    body.append(prefix);
+    appendJsonEscaped(body, componentName);
+    body.append("\"}");
+}
+
+/**
+ * @brief skip whitespaces in a json-string
+ */
+static inline void
+skipWhitespaces(const std::string &input,
+                size_t &pos)
+{
+    while(pos < input.size()
+          && (input[pos] == ' '
+              || input[pos] == '\n'
+              || input[pos] == '\r'
+              || input[pos] == '\t'))
+    {
+        pos++;
+    }
+}
+
+/**
+ * @brief read a json-string without escape-sequences
+ *
+ * @param result reference for the view on the content of the string
+ * @param input complete json-string
+ * @param pos position of the opening quote, which is moved behind the closing quote
+ *
+ * @return false, if not a string or if the string contains escape-sequences, else true
+ */
+static inline bool
+readPlainString(std::string_view &result,
+                const std::string &input,
+                size_t &pos)
+{
+    if(pos >= input.size()
+            || input[pos] != '"')
+    {
+        return false;
+    }
+
+    const size_t start = pos + 1;
+    size_t end = start;
+    while(end < input.size()
+          && input[end] != '"')
+    {
+        if(input[end] == '\\') {
+            return false;
+        }
+        end++;
+    }
+
+    if(end >= input.size()) {
+        return false;
+    }
+
+    result = std::string_view(&input[start], end - start);
+    pos = end + 1;
+
+    return true;
+}
+
+/**
+ * @brief skip a json-value, which is not a string-value with escape-sequences
+ *
+ * @param input complete json-string
+ * @param pos position of the start of the value, which is moved behind the value
+ *
+ * @return false, if the value is not supported, else true
+ */
+static bool
+skipValue(const std::string &input,
+          size_t &pos)
+{
+    std::string_view ignore;
+    uint32_t depth = 0;
+
+    do
+    {
+        skipWhitespaces(input, pos);
+        if(pos >= input.size()) {
+            return false;
+        }
+
+        const char c = input[pos];
+        if(c == '"')
+        {
+            if(readPlainString(ignore, input, pos) == false) {
+                return false;
+            }
+        }
+        else if(c == '{' || c == '[')
+        {
+            depth++;
+            pos++;
+        }
+        else if(c == '}' || c == ']')
+        {
+            if(depth == 0) {
+                return false;
+            }
+            depth--;
+            pos++;
+        }
+        else
+        {
+            // numbers, literals and separators within nested values
+            pos++;
+            while(pos < input.size()
+                  && depth == 0
+                  && input[pos] != ','
+                  && input[pos] != '}')
+            {
+                pos++;
+            }
+        }
+    }
+    while(depth > 0);
+
+    return true;
+}
+
+/**
+ * @brief check if a string is a syntactical valid jwt-token, so it has three parts with
+ *        base64url-characters, which are separated by dots
+ *
+ * @param token token to check
+ *
+ * @return true, if valid, else false
+ */
+static bool
+isValidTokenString(const std::string_view &token)
+{
+    uint32_t numberOfDots = 0;
+    for(const char c : token)
+    {
+        if(c == '.')
+        {
+            numberOfDots++;
+            continue;
+        }
+
+        if((c >= 'a' && c <= 'z')
+                || (c >= 'A' && c <= 'Z')
+                || (c >= '0' && c <= '9')
+                || c == '-'
+                || c == '_')
+        {
+            continue;
+        }
+
+        return false;
+    }
+
+    return numberOfDots == 2;
+}
+
+/**
+ * @brief find the token-field in the top-level object of a response of misaki, without
+ *        allocating any memory
+ *
+ * @param token reference for the view on the token within the response
+ * @param responseContent json-string of the response
+ *
+ * @return false, if the token-field was not found or has an unexpected shape, else true
+ */
+bool
+findTokenInResponse(std::string_view &token,
+                    const std::string &responseContent)
+{
+    size_t pos = 0;
+    skipWhitespaces(responseContent, pos);
+    if(pos >= responseContent.size()
+            || responseContent[pos] != '{')
+    {
+        return false;
+    }
+    pos++;
+
+    while(pos < responseContent.size())
+    {
+        // read key
+        std::string_view key;
+        skipWhitespaces(responseContent, pos);
+        if(readPlainString(key, responseContent, pos) == false) {
+            return false;
+        }
+
+        skipWhitespaces(responseContent, pos);
+        if(pos >= responseContent.size()
+                || responseContent[pos] != ':')
+        {
+            return false;
+        }
+        pos++;
+        skipWhitespaces(responseContent, pos);
+
+        // read value
+        if(key == "token")
+        {
+            if(readPlainString(token, responseContent, pos) == false) {
+                return false;
+            }
+            return isValidTokenString(token);
+        }
+
+        if(skipValue(responseContent, pos) == false) {
+            return false;
+        }
+
+        // go to next key
+        skipWhitespaces(responseContent, pos);
+        if(pos >= responseContent.size()
+                || responseContent[pos] != ',')
+        {
+            return false;
+        }
+        pos++;
+    }
+
+    return false;
+}
+
+/**
+ * @brief get token from the response of misaki. The response is first checked by an
+ *        allocation-free reader and only parsed by the full json-parser, if it has an
+ *        unexpected shape.
+ *
+ * @param token reference for the resulting token
+ * @param responseContent json-string of the response
+ * @param error reference for error-output
+ *
+ * @return false, if the response has no valid token, else true
+ */
+bool
+readTokenFromResponse(std::string &token,
+                      const std::string &responseContent,
+                      ErrorContainer &error)
+{
+    ScopedLatency latency(TOKEN_PARSE_LATENCY_NS);
+
+    std::string_view tokenView;
+    if(findTokenInResponse(tokenView, responseContent))
+    {
+        token.assign(tokenView.data(), tokenView.size());
+        return true;
+    }
+
+    // fallback to the full json-parser
+    JsonItem jsonItem;
+    if(jsonItem.parse(responseContent, error) == false)
+    {
+        error.addMeesage("Failed to parse internal jwt-token from response of misaki");
+        return false;
+    }
+
+    if(jsonItem.isMap() == false
+            || jsonItem.contains("token") == false)
+    {
+        error.addMeesage("Response of misaki has no token-field");
+        return false;
+    }
+
+    // the same check like in the fast path, so both paths accept the same tokens
+    const std::string parsedToken = jsonItem.get("token").getString();
+    if(isValidTokenString(parsedToken) == false)
+    {
+        error.addMeesage("Internal jwt-token in the response of misaki is empty or invalid");
+        return false;
+    }
+
+    token = parsedToken;
+
+    return true;
+}
+
+}  // namespace Misaki
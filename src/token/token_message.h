@@ -0,0 +1,47 @@
+/**
+ * @file        token_message.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_TOKEN_MESSAGE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_TOKEN_MESSAGE_H
+
+#include <string>
+#include <string_view>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Misaki
+{
+
+void appendJsonEscaped(std::string &output,
+                       const std::string &input);
+void createTokenRequestBody(std::string &body,
+                            const std::string &componentName);
+
+bool findTokenInResponse(std::string_view &token,
+                         const std::string &responseContent);
+bool readTokenFromResponse(std::string &token,
+                           const std::string &responseContent,
+                           Kitsunemimi::ErrorContainer &error);
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_TOKEN_MESSAGE_H
@@ -0,0 +1,159 @@
+/**
+ * @file        token_refresher.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <token/token_refresher.h>
+#include <token/token_cache.h>
+#include <token/token_fetcher.h>
+#include <common/misaki_call_guard.h>
+
+#include <vector>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+TokenRefresher::TokenRefresher()
+    : Kitsunemimi::Thread("MisakiGuard_TokenRefresher")
+{
+    m_refreshMargin = 300;
+    m_isRunning = false;
+}
+
+/**
+ * @brief get instance of the token-refresher
+ *
+ * @return pointer to the static instance
+ */
+TokenRefresher*
+TokenRefresher::getInstance()
+{
+    static TokenRefresher instance;
+    return &instance;
+}
+
+/**
+ * @brief start the background-refresh of all cached internal tokens
+ *
+ * @param refreshMargin time in seconds before the expiration of a token, where it is renewed
+ *
+ * @return false, if already running or start failed, else true
+ */
+bool
+TokenRefresher::startRefresh(const uint32_t refreshMargin)
+{
+    m_refreshMargin = refreshMargin;
+
+    bool expected = false;
+    if(m_isRunning.compare_exchange_strong(expected, true) == false) {
+        return false;
+    }
+
+    if(startThread() == false)
+    {
+        m_isRunning = false;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief stop the background-refresh and wait until the thread is finished
+ */
+void
+TokenRefresher::stopRefresh()
+{
+    if(m_isRunning == false) {
+        return;
+    }
+
+    stopThread();
+}
+
+/**
+ * @brief check if the background-refresh is active
+ *
+ * @return true, if running, else false
+ */
+bool
+TokenRefresher::isRunning() const
+{
+    return m_isRunning;
+}
+
+/**
+ * @brief loop, which renews all cached tokens shortly before they expire. The new token is
+ *        published by the token-cache without blocking any reader. If the renew fails, the old
+ *        token stays in the cache and is served until it expires, while the next try is done
+ *        in the next cycle.
+ */
+void
+TokenRefresher::run()
+{
+    TokenCache* tokenCache = TokenCache::getInstance();
+    TokenFetcher* tokenFetcher = TokenFetcher::getInstance();
+
+    while(m_abort == false)
+    {
+        // requests to misaki, which hang, are also expired without any new request
+        tokenFetcher->expireRequests();
+
+        std::vector<std::string> componentNames;
+        tokenCache->getRefreshCandidates(componentNames, m_refreshMargin);
+
+        // the fetcher stores the new token in the cache and shares the request with
+        // callers of getInternalToken, which are waiting for the same component
+        for(const std::string &componentName : componentNames)
+        {
+            const std::shared_future<InternalTokenResult> future =
+                    tokenFetcher->fetch(componentName);
+            const std::chrono::steady_clock::time_point deadline =
+                    MisakiCallGuard::getInstance()->getDeadline();
+            if(future.wait_until(deadline) != std::future_status::ready)
+            {
+                ErrorContainer error;
+                error.addMeesage("Deadline for the refresh of the internal jwt-token of "
+                                 "component '" + componentName + "' reached");
+                LOG_ERROR(error);
+                continue;
+            }
+
+            InternalTokenResult result = future.get();
+            if(result.success == false)
+            {
+                result.error.addMeesage("Failed to refresh internal jwt-token of component '"
+                                        + componentName + "'");
+                LOG_ERROR(result.error);
+            }
+        }
+
+        sleepThread(1000000);
+    }
+
+    m_isRunning = false;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,55 @@
+/**
+ * @file        token_refresher.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_TOKEN_REFRESHER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_TOKEN_REFRESHER_H
+
+#include <atomic>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Misaki
+{
+
+class TokenRefresher
+        : public Kitsunemimi::Thread
+{
+public:
+    static TokenRefresher* getInstance();
+
+    bool startRefresh(const uint32_t refreshMargin);
+    void stopRefresh();
+    bool isRunning() const;
+
+protected:
+    void run();
+
+private:
+    TokenRefresher();
+
+    std::atomic<uint32_t> m_refreshMargin;
+    std::atomic<bool> m_isRunning;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_TOKEN_REFRESHER_H
@@ -0,0 +1,91 @@
+/**
+ * @file        token_request.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <token/token_request.h>
+#include <token/token_message.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+using Kitsunemimi::Hanami::HanamiMessagingClient;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * @brief request a new internal jwt-token from misaki
+ *
+ * @param token reference for the resulting token
+ * @param componentName name of the component where the token is for
+ * @param error reference for error-output
+ *
+ * @return MISAKI_CALL_OK, if successful, MISAKI_CALL_UNREACHABLE, if misaki could not be
+ *         reached, else MISAKI_CALL_REJECTED
+ */
+MisakiCallResult
+requestInternalToken(std::string &token,
+                     const std::string &componentName,
+                     Kitsunemimi::ErrorContainer &error)
+{
+    HanamiMessagingClient* misakiClient = HanamiMessaging::getInstance()->misakiClient;
+    Kitsunemimi::Hanami::ResponseMessage response;
+
+    // create request
+    Kitsunemimi::Hanami::RequestMessage request;
+    request.id = "v1/token/internal";
+    request.httpType = Kitsunemimi::Hanami::POST_TYPE;
+    createTokenRequestBody(request.inputValues, componentName);
+
+    // request internal jwt-token from misaki
+    if(misakiClient->triggerSakuraFile(response, request, error) == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get a internal jwt-token");
+        LOG_ERROR(error);
+        return MISAKI_CALL_UNREACHABLE;
+    }
+
+    // check response
+    if(response.success == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get a internal jwt-token (no success)");
+        LOG_ERROR(error);
+        return MISAKI_CALL_REJECTED;
+    }
+
+    // get token from response
+    if(readTokenFromResponse(token, response.responseContent, error) == false)
+    {
+        LOG_ERROR(error);
+        return MISAKI_CALL_REJECTED;
+    }
+    if(token == "")
+    {
+        error.addMeesage("Internal jwt-token from misaki is empty");
+        LOG_ERROR(error);
+        return MISAKI_CALL_REJECTED;
+    }
+
+    return MISAKI_CALL_OK;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,172 @@
+/**
+ * @file        key_file_watcher.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/key_file_watcher.h>
+#include <validation/key_store.h>
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ *
+ * @param filePath path to the key-file
+ */
+KeyFileWatcher::KeyFileWatcher(const std::string &filePath)
+    : Kitsunemimi::Thread("Misaki_KeyFileWatcher"),
+      m_filePath(filePath)
+{
+    const size_t lastSlash = m_filePath.find_last_of('/');
+    if(lastSlash == std::string::npos)
+    {
+        m_directoryPath = ".";
+        m_fileName = m_filePath;
+    }
+    else
+    {
+        m_directoryPath = m_filePath.substr(0, lastSlash + 1);
+        m_fileName = m_filePath.substr(lastSlash + 1);
+    }
+}
+
+/**
+ * @brief destructor, which stops the thread before the inotify-fd is closed, because the
+ *        thread polls on it
+ */
+KeyFileWatcher::~KeyFileWatcher()
+{
+    stopThread();
+
+    if(m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+    }
+}
+
+/**
+ * @brief register the watch and start the thread. The directory is watched instead of the
+ *        file itself, because most tools replace the file by a rename, which would silently
+ *        end a watch on the old inode.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+KeyFileWatcher::startWatching(ErrorContainer &error)
+{
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_inotifyFd < 0)
+    {
+        error.addMeesage("Failed to init inotify for the key-file '" + m_filePath + "'");
+        return false;
+    }
+
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+    if(inotify_add_watch(m_inotifyFd, m_directoryPath.c_str(), mask) < 0)
+    {
+        error.addMeesage("Failed to watch directory '" + m_directoryPath + "' of the key-file");
+        return false;
+    }
+
+    if(startThread() == false)
+    {
+        error.addMeesage("Failed to start thread to watch the key-file '" + m_filePath + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief wait up to one second for events within the watched directory
+ *
+ * @return true, if the key-file was changed, else false
+ */
+bool
+KeyFileWatcher::waitForChange()
+{
+    pollfd pollFd;
+    pollFd.fd = m_inotifyFd;
+    pollFd.events = POLLIN;
+    pollFd.revents = 0;
+    if(poll(&pollFd, 1, 1000) <= 0) {
+        return false;
+    }
+
+    bool changed = false;
+    alignas(inotify_event) char buffer[4096];
+    while(true)
+    {
+        const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if(length <= 0) {
+            break;
+        }
+
+        ssize_t pos = 0;
+        while(pos < length)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(&buffer[pos]);
+            if(event->len > 0
+                    && m_fileName == event->name)
+            {
+                changed = true;
+            }
+            pos += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * @brief loop, which reloads the keys after each change of the key-file. If the new file is
+ *        invalid, the old keys stay active.
+ */
+void
+KeyFileWatcher::run()
+{
+    while(m_abort == false)
+    {
+        if(waitForChange() == false) {
+            continue;
+        }
+
+        ErrorContainer error;
+        if(KeyStore::getInstance()->loadFromFile(m_filePath, error) == false)
+        {
+            error.addMeesage("Failed to reload keys, so the old keys are still used");
+            LOG_ERROR(error);
+        }
+        else
+        {
+            LOG_INFO("Reloaded keys for the validation of jwt-tokens from '" + m_filePath + "'");
+        }
+    }
+}
+
+}  // namespace Misaki
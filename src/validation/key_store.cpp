@@ -0,0 +1,388 @@
+/**
+ * @file        key_store.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/key_store.h>
+#include <validation/key_file_watcher.h>
+#include <validation/verified_token_cache.h>
+#include <token/jwt_helper.h>
+#include <common/digest.h>
+
+#include <libKitsunemimiJwt/jwt.h>
+#include <libKitsunemimiCommon/files/text_file.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessagingClient;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * @brief destructor
+ */
+KeyStore::KeySet::~KeySet()
+{
+    for(auto& [kid, jwt] : jwts) {
+        delete jwt;
+    }
+}
+
+/**
+ * @brief constructor
+ */
+KeyStore::KeyStore() {}
+
+/**
+ * @brief destructor
+ */
+KeyStore::~KeyStore()
+{
+    stopWatching();
+}
+
+/**
+ * @brief get instance of the key-store
+ *
+ * @return pointer to the static instance
+ */
+KeyStore*
+KeyStore::getInstance()
+{
+    static KeyStore instance;
+    return &instance;
+}
+
+/**
+ * @brief replace all keys at once. Running validations still use the old keys, until they
+ *        are finished.
+ *
+ * @param keys map with key-id as key and the secret as value. The key-id of a key, which is
+ *             used for tokens without kid-header, is an empty string.
+ * @param error reference for error-output
+ *
+ * @return false, if no or an empty key was given, else true
+ */
+bool
+KeyStore::setKeys(const std::map<std::string, std::string> &keys,
+                  ErrorContainer &error)
+{
+    if(keys.size() == 0)
+    {
+        error.addMeesage("No keys for the validation of jwt-tokens given");
+        return false;
+    }
+
+    KeySet* newKeySet = new KeySet();
+    for(const auto& [kid, secret] : keys)
+    {
+        if(secret.size() == 0)
+        {
+            error.addMeesage("Key with id '" + kid + "' for the validation of jwt-tokens is empty");
+            delete newKeySet;
+            return false;
+        }
+
+        const CryptoPP::SecByteBlock key((unsigned char*)secret.c_str(), secret.size());
+        newKeySet->jwts.emplace(kid, new Jwt::Jwt(key));
+    }
+
+    std::lock_guard<std::mutex> guard(m_publishLock);
+
+    m_generation++;
+    newKeySet->generation = m_generation;
+    m_keySet.publish(newKeySet);
+    m_lastContentDigest = 0;
+
+    // tokens, which were validated with a removed key, have to be validated again. The new
+    // generation is set after the publish, so results of validations with the old keys, which
+    // are still running, are rejected by the cache.
+    VerifiedTokenCache::getInstance()->setKeyGeneration(m_generation);
+
+    return true;
+}
+
+/**
+ * @brief parse and apply keys. The content is either a json-object with the form
+ *        {"keys": [{"kid": "<ID>", "key": "<SECRET>"}, ...]} or a single plain key.
+ *        Content, which is identical to the last loaded one, is ignored.
+ *
+ * @param content content of a key-file or response of misaki
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+KeyStore::loadFromString(const std::string &content,
+                         ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_loadLock);
+
+    // editors and config-management often write the same content again
+    const uint64_t contentDigest = calcDigest(content);
+    if(contentDigest == m_lastContentDigest
+            && hasKeys())
+    {
+        return true;
+    }
+
+    std::map<std::string, std::string> keys;
+
+    const size_t firstChar = content.find_first_not_of(" \t\r\n");
+    if(firstChar != std::string::npos
+            && content.at(firstChar) == '{')
+    {
+        JsonItem parsed;
+        if(parsed.parse(content, error) == false)
+        {
+            error.addMeesage("Failed to parse keys for the validation of jwt-tokens");
+            return false;
+        }
+
+        JsonItem keyList = parsed.get("keys");
+        if(keyList.isArray() == false)
+        {
+            error.addMeesage("Keys for the validation of jwt-tokens have no keys-array");
+            return false;
+        }
+
+        for(uint64_t i = 0; i < keyList.size(); i++)
+        {
+            JsonItem entry = keyList.get(i);
+            keys[entry.get("kid").getString()] = entry.get("key").getString();
+        }
+    }
+    else
+    {
+        // single key without id, where only the trailing line-break is removed
+        const size_t lastChar = content.find_last_not_of("\r\n");
+        if(lastChar != std::string::npos) {
+            keys[""] = content.substr(0, lastChar + 1);
+        }
+    }
+
+    if(setKeys(keys, error) == false) {
+        return false;
+    }
+
+    m_lastContentDigest = contentDigest;
+
+    return true;
+}
+
+/**
+ * @brief load keys from a local file
+ *
+ * @param filePath path to the key-file
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+KeyStore::loadFromFile(const std::string &filePath,
+                       ErrorContainer &error)
+{
+    std::string content;
+    if(readFile(content, filePath, error) == false)
+    {
+        error.addMeesage("Failed to read key-file '" + filePath + "'");
+        return false;
+    }
+
+    if(loadFromString(content, error) == false)
+    {
+        error.addMeesage("Failed to load keys from file '" + filePath + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief load keys from misaki
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+KeyStore::loadFromMisaki(ErrorContainer &error)
+{
+    HanamiMessagingClient* misakiClient = HanamiMessaging::getInstance()->misakiClient;
+    Hanami::ResponseMessage response;
+
+    // create request
+    Hanami::RequestMessage request;
+    request.id = "v1/token/keys";
+    request.httpType = Hanami::GET_TYPE;
+    request.inputValues = "{}";
+
+    // request keys from misaki
+    if(misakiClient->triggerSakuraFile(response, request, error) == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get the keys for jwt-tokens");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // check response
+    if(response.success == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get the keys for jwt-tokens (no success)");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    return loadFromString(response.responseContent, error);
+}
+
+/**
+ * @brief load keys from a file and reload them, every time the file was changed
+ *
+ * @param filePath path to the key-file
+ * @param error reference for error-output
+ *
+ * @return false, if the initial load or the start of the watcher failed, else true
+ */
+bool
+KeyStore::startWatching(const std::string &filePath,
+                        ErrorContainer &error)
+{
+    if(loadFromFile(filePath, error) == false) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_loadLock);
+
+    if(m_watcher != nullptr)
+    {
+        error.addMeesage("Key-file is already watched");
+        return false;
+    }
+
+    m_watcher = new KeyFileWatcher(filePath);
+    if(m_watcher->startWatching(error) == false)
+    {
+        delete m_watcher;
+        m_watcher = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief stop watching the key-file. The watcher is deleted outside of the load-lock, because
+ *        its thread could wait for this lock to reload the keys.
+ */
+void
+KeyStore::stopWatching()
+{
+    KeyFileWatcher* watcher = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_loadLock);
+        watcher = m_watcher;
+        m_watcher = nullptr;
+    }
+
+    // the destructor stops and joins the thread
+    delete watcher;
+}
+
+/**
+ * @brief check if at least one key is loaded
+ *
+ * @return true, if keys are loaded, else false
+ */
+bool
+KeyStore::hasKeys() const
+{
+    return m_keySet.read().get() != nullptr;
+}
+
+/**
+ * @brief check the signature of a token with the key, which is selected by the kid-header
+ *        of the token. Tokens without kid are checked with the key without id or, if there is
+ *        only one key, with this one.
+ *
+ * @param payload reference for the payload of the token
+ * @param keyGeneration reference for the generation of the key-set, which was used
+ * @param token jwt-token to check
+ * @param error reference for error-output
+ *
+ * @return true, if the signature is valid, else false
+ */
+bool
+KeyStore::validateSignature(JsonItem &payload,
+                            uint64_t &keyGeneration,
+                            const std::string &token,
+                            ErrorContainer &error) const
+{
+    const RcuPointer<KeySet>::ReadGuard keySet = m_keySet.read();
+    if(keySet.get() == nullptr)
+    {
+        error.addMeesage("No key for the local validation of jwt-tokens was initialized");
+        return false;
+    }
+    keyGeneration = keySet->generation;
+
+    // select key
+    Jwt::Jwt* jwt = nullptr;
+    if(keySet->jwts.size() == 1
+            && keySet->jwts.begin()->first == "")
+    {
+        jwt = keySet->jwts.begin()->second;
+    }
+    else
+    {
+        JsonItem header;
+        if(parseJwtPart(header, token, JWT_HEADER_PART, error) == false) {
+            return false;
+        }
+
+        const std::string kid = header.contains("kid") ? header.get("kid").getString() : "";
+        auto it = keySet->jwts.find(kid);
+        if(it == keySet->jwts.end()
+                && kid == ""
+                && keySet->jwts.size() == 1)
+        {
+            it = keySet->jwts.begin();
+        }
+        if(it == keySet->jwts.end())
+        {
+            error.addMeesage("No key with id '" + kid + "' for the jwt-token available");
+            return false;
+        }
+        jwt = it->second;
+    }
+
+    if(jwt->validateToken(payload, token, error) == false)
+    {
+        error.addMeesage("Signature of the jwt-token is invalid");
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace Misaki
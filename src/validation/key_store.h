@@ -0,0 +1,89 @@
+/**
+ * @file        key_store.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_KEY_STORE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_KEY_STORE_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+#include <common/rcu_pointer.h>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiJson/json_item.h>
+
+namespace Kitsunemimi {
+namespace Jwt {
+class Jwt;
+}
+}
+
+namespace Misaki
+{
+class KeyFileWatcher;
+
+class KeyStore
+{
+public:
+    static KeyStore* getInstance();
+
+    bool setKeys(const std::map<std::string, std::string> &keys,
+                 Kitsunemimi::ErrorContainer &error);
+    bool loadFromString(const std::string &content,
+                        Kitsunemimi::ErrorContainer &error);
+    bool loadFromFile(const std::string &filePath,
+                      Kitsunemimi::ErrorContainer &error);
+    bool loadFromMisaki(Kitsunemimi::ErrorContainer &error);
+    bool startWatching(const std::string &filePath,
+                       Kitsunemimi::ErrorContainer &error);
+    void stopWatching();
+
+    bool hasKeys() const;
+    bool validateSignature(Kitsunemimi::JsonItem &payload,
+                           uint64_t &keyGeneration,
+                           const std::string &token,
+                           Kitsunemimi::ErrorContainer &error) const;
+
+private:
+    KeyStore();
+    ~KeyStore();
+
+    struct KeySet
+    {
+        std::map<std::string, Kitsunemimi::Jwt::Jwt*> jwts;
+        uint64_t generation = 0;
+        ~KeySet();
+    };
+
+    RcuPointer<KeySet> m_keySet;
+    std::mutex m_loadLock;
+    std::mutex m_publishLock;
+    uint64_t m_generation = 0;
+    std::atomic<uint64_t> m_lastContentDigest {0};
+    KeyFileWatcher* m_watcher = nullptr;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_KEY_STORE_H
@@ -0,0 +1,265 @@
+/**
+ * @file        request_validator.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/request_validator.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+RequestValidator::RequestValidator() {}
+
+/**
+ * @brief compile the input-validation-map of a blossom into the flat check-table
+ *
+ * @param defMap input-validation-map of the blossom
+ * @param error reference for error-output
+ *
+ * @return false, if a regex of the map is invalid, else true
+ */
+bool
+RequestValidator::compile(const std::map<std::string, Hanami::FieldDef> &defMap,
+                          ErrorContainer &error)
+{
+    m_names.clear();
+    m_checks.clear();
+    m_regexes.clear();
+    m_matchValues.clear();
+
+    m_names.reserve(defMap.size());
+    m_checks.reserve(defMap.size());
+
+    // the map is already sorted by name, so the table has the same order like the input-maps
+    for(const auto& [name, def] : defMap)
+    {
+        FieldCheck check;
+        check.fieldType = def.fieldType;
+        check.isRequired = def.isRequired;
+
+        if(def.regex != ""
+                && def.fieldType == Hanami::SAKURA_STRING_TYPE)
+        {
+            try
+            {
+                m_regexes.emplace_back(def.regex, std::regex::ECMAScript | std::regex::optimize);
+            }
+            catch(const std::regex_error &e)
+            {
+                error.addMeesage("Invalid regex '" + def.regex + "' for field '" + name + "': "
+                                 + e.what());
+                return false;
+            }
+            check.regexPos = static_cast<uint32_t>(m_regexes.size() - 1);
+            check.checks |= CHECK_REGEX;
+        }
+
+        if(def.match != nullptr)
+        {
+            m_matchValues.push_back(def.match->toString());
+            check.matchPos = static_cast<uint32_t>(m_matchValues.size() - 1);
+            check.checks |= CHECK_MATCH;
+        }
+
+        if(def.lowerBorder != 0
+                || def.upperBorder != 0)
+        {
+            check.lowerBorder = def.lowerBorder;
+            check.upperBorder = def.upperBorder;
+            if(def.fieldType == Hanami::SAKURA_INT_TYPE) {
+                check.checks |= CHECK_VALUE_BORDER;
+            } else if(def.fieldType == Hanami::SAKURA_STRING_TYPE) {
+                check.checks |= CHECK_LENGTH_BORDER;
+            }
+        }
+
+        m_names.push_back(name);
+        m_checks.push_back(check);
+    }
+
+    return true;
+}
+
+/**
+ * @brief check the input of a request against the compiled fields
+ *
+ * @param input input-values of the request
+ * @param error reference for error-output
+ *
+ * @return true, if the input is valid, else false
+ */
+bool
+RequestValidator::validate(const DataMap &input,
+                           ErrorContainer &error) const
+{
+    // both lists are sorted by name, so unknown and missing fields are found in one pass
+    auto inputIt = input.map.begin();
+    for(uint64_t i = 0; i < m_names.size(); i++)
+    {
+        while(inputIt != input.map.end()
+              && inputIt->second == nullptr)
+        {
+            inputIt++;
+        }
+
+        if(inputIt != input.map.end()
+                && inputIt->first < m_names[i])
+        {
+            error.addMeesage("Field '" + inputIt->first + "' is not allowed");
+            return false;
+        }
+
+        if(inputIt != input.map.end()
+                && inputIt->first == m_names[i])
+        {
+            if(checkField(m_checks[i], m_names[i], inputIt->second, error) == false) {
+                return false;
+            }
+            inputIt++;
+        }
+        else if(m_checks[i].isRequired)
+        {
+            error.addMeesage("Required field '" + m_names[i] + "' is missing");
+            return false;
+        }
+    }
+
+    for(; inputIt != input.map.end(); inputIt++)
+    {
+        if(inputIt->second != nullptr)
+        {
+            error.addMeesage("Field '" + inputIt->first + "' is not allowed");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of compiled fields
+ *
+ * @return number of fields
+ */
+uint64_t
+RequestValidator::getNumberOfFields() const
+{
+    return m_names.size();
+}
+
+/**
+ * @brief check a single value against its compiled field
+ *
+ * @param check compiled checks of the field
+ * @param name name of the field for the error-message
+ * @param value value of the request
+ * @param error reference for error-output
+ *
+ * @return true, if the value is valid, else false
+ */
+bool
+RequestValidator::checkField(const FieldCheck &check,
+                             const std::string &name,
+                             const DataItem* value,
+                             ErrorContainer &error) const
+{
+    if(checkType(check.fieldType, value) == false)
+    {
+        error.addMeesage("Field '" + name + "' has the wrong type");
+        return false;
+    }
+
+    if(check.checks & CHECK_VALUE_BORDER)
+    {
+        const long intValue = value->getLong();
+        if(intValue < check.lowerBorder
+                || intValue > check.upperBorder)
+        {
+            error.addMeesage("Value of field '" + name + "' is not between "
+                             + std::to_string(check.lowerBorder) + " and "
+                             + std::to_string(check.upperBorder));
+            return false;
+        }
+    }
+
+    if(check.checks & (CHECK_LENGTH_BORDER | CHECK_REGEX))
+    {
+        const std::string stringValue = value->getString();
+        if(check.checks & CHECK_LENGTH_BORDER)
+        {
+            const long length = static_cast<long>(stringValue.size());
+            if(length < check.lowerBorder
+                    || length > check.upperBorder)
+            {
+                error.addMeesage("Length of field '" + name + "' is not between "
+                                 + std::to_string(check.lowerBorder) + " and "
+                                 + std::to_string(check.upperBorder));
+                return false;
+            }
+        }
+
+        if((check.checks & CHECK_REGEX)
+                && std::regex_match(stringValue, m_regexes[check.regexPos]) == false)
+        {
+            error.addMeesage("Value of field '" + name + "' doesn't match the regex");
+            return false;
+        }
+    }
+
+    if((check.checks & CHECK_MATCH)
+            && value->toString() != m_matchValues[check.matchPos])
+    {
+        error.addMeesage("Value of field '" + name + "' doesn't match the expected value");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief check if a value has the type of a field
+ *
+ * @param fieldType type of the field
+ * @param value value of the request
+ *
+ * @return true, if the type matches, else false
+ */
+bool
+RequestValidator::checkType(const Hanami::FieldType fieldType,
+                            const DataItem* value)
+{
+    switch(fieldType)
+    {
+        case Hanami::SAKURA_INT_TYPE:    return value->isIntValue();
+        case Hanami::SAKURA_FLOAT_TYPE:  return value->isFloatValue() || value->isIntValue();
+        case Hanami::SAKURA_BOOL_TYPE:   return value->isBoolValue();
+        case Hanami::SAKURA_STRING_TYPE: return value->isStringValue();
+        case Hanami::SAKURA_ARRAY_TYPE:  return value->isArray();
+        case Hanami::SAKURA_MAP_TYPE:    return value->isMap();
+        default:                         return true;
+    }
+}
+
+}  // namespace Misaki
@@ -0,0 +1,90 @@
+/**
+ * @file        request_validator.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_REQUEST_VALIDATOR_H
+#define KITSUNEMIMI_HANAMI_MISAKI_REQUEST_VALIDATOR_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+
+namespace Misaki
+{
+
+/**
+ * Precompiled form of the input-validation-map of a blossom. The fields are stored in a flat
+ * table, which is sorted by name, so a request is checked with a single merge-walk over the
+ * sorted input-map. Regexes and match-values are prepared once while compiling.
+ */
+class RequestValidator
+{
+public:
+    RequestValidator();
+
+    bool compile(const std::map<std::string, Kitsunemimi::Hanami::FieldDef> &defMap,
+                 Kitsunemimi::ErrorContainer &error);
+    bool validate(const Kitsunemimi::DataMap &input,
+                  Kitsunemimi::ErrorContainer &error) const;
+
+    uint64_t getNumberOfFields() const;
+
+private:
+    enum CheckFlags
+    {
+        CHECK_REGEX = 1,
+        CHECK_MATCH = 2,
+        CHECK_VALUE_BORDER = 4,
+        CHECK_LENGTH_BORDER = 8,
+    };
+
+    struct FieldCheck
+    {
+        Kitsunemimi::Hanami::FieldType fieldType = Kitsunemimi::Hanami::SAKURA_UNDEFINED_TYPE;
+        bool isRequired = false;
+        uint8_t checks = 0;
+        long lowerBorder = 0;
+        long upperBorder = 0;
+        uint32_t regexPos = 0;
+        uint32_t matchPos = 0;
+    };
+
+    std::vector<std::string> m_names;
+    std::vector<FieldCheck> m_checks;
+    std::vector<std::regex> m_regexes;
+    std::vector<std::string> m_matchValues;
+
+    bool checkField(const FieldCheck &check,
+                    const std::string &name,
+                    const Kitsunemimi::DataItem* value,
+                    Kitsunemimi::ErrorContainer &error) const;
+    static bool checkType(const Kitsunemimi::Hanami::FieldType fieldType,
+                          const Kitsunemimi::DataItem* value);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_REQUEST_VALIDATOR_H
@@ -0,0 +1,167 @@
+/**
+ * @file        request_validator_store.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/request_validator_store.h>
+
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+RequestValidatorStore::RequestValidatorStore()
+    : m_index(new ValidatorIndex()) {}
+
+/**
+ * @brief get instance of the validator-store
+ *
+ * @return pointer to the static instance
+ */
+RequestValidatorStore*
+RequestValidatorStore::getInstance()
+{
+    static RequestValidatorStore instance;
+    return &instance;
+}
+
+/**
+ * @brief compile the input-validation-maps of all blossoms, which are registered as endpoint,
+ *        and replace the actual validators without blocking running checks
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if a validation-map can not be compiled, else true
+ */
+bool
+RequestValidatorStore::build(ErrorContainer &error)
+{
+    HanamiMessaging* langInterface = HanamiMessaging::getInstance();
+    ValidatorIndex* newIndex = new ValidatorIndex();
+    std::map<const Hanami::Blossom*, int32_t> validatorPositions;
+
+    for(const auto& [endpoint, rules] : langInterface->endpointRules)
+    {
+        std::array<int32_t, NUMBER_OF_HTTP_TYPES> positions;
+        positions.fill(-1);
+
+        for(const auto& [httpType, entry] : rules)
+        {
+            const int32_t typePos = getHttpTypePos(httpType);
+            if(typePos == -1
+                    || entry.type != Hanami::BLOSSOM_TYPE)
+            {
+                continue;
+            }
+
+            const Hanami::Blossom* blossom = langInterface->getBlossom(entry.group, entry.name);
+            if(blossom == nullptr) {
+                continue;
+            }
+
+            // compile each blossom only once, even if it is used by multiple endpoints
+            const auto it = validatorPositions.find(blossom);
+            if(it != validatorPositions.end())
+            {
+                positions[typePos] = it->second;
+                continue;
+            }
+
+            RequestValidator validator;
+            if(validator.compile(*blossom->getInputValidationMap(), error) == false)
+            {
+                error.addMeesage("Failed to compile input-validation of blossom '"
+                                 + entry.name + "' in group '" + entry.group + "'");
+                delete newIndex;
+                return false;
+            }
+
+            const int32_t validatorPos = static_cast<int32_t>(newIndex->validators.size());
+            newIndex->validators.push_back(std::move(validator));
+            validatorPositions.emplace(blossom, validatorPos);
+            positions[typePos] = validatorPos;
+        }
+
+        newIndex->endpoints.emplace(endpoint, positions);
+    }
+
+    m_index.publish(newIndex);
+
+    return true;
+}
+
+/**
+ * @brief check the input of a request with the precompiled validator of the endpoint
+ *
+ * @param endpoint requested endpoint
+ * @param httpType http-type of the request
+ * @param input input-values of the request
+ * @param error reference for error-output
+ *
+ * @return true, if the input is valid, else false
+ */
+bool
+RequestValidatorStore::validate(const std::string &endpoint,
+                                const Hanami::HttpRequestType httpType,
+                                const DataMap &input,
+                                ErrorContainer &error) const
+{
+    const RcuPointer<ValidatorIndex>::ReadGuard index = m_index.read();
+
+    const int32_t typePos = getHttpTypePos(httpType);
+    const auto it = index->endpoints.find(endpoint);
+    if(typePos == -1
+            || it == index->endpoints.end()
+            || it->second[typePos] == -1)
+    {
+        error.addMeesage("No validator found for endpoint '" + endpoint + "'");
+        return false;
+    }
+
+    return index->validators[it->second[typePos]].validate(input, error);
+}
+
+/**
+ * @brief get position of a http-type within the validator-positions of an endpoint
+ *
+ * @param httpType http-type to convert
+ *
+ * @return position of the http-type or -1, if the type is not supported
+ */
+int32_t
+RequestValidatorStore::getHttpTypePos(const Hanami::HttpRequestType httpType)
+{
+    switch(httpType)
+    {
+        case Hanami::DELETE_TYPE: return 0;
+        case Hanami::GET_TYPE:    return 1;
+        case Hanami::POST_TYPE:   return 2;
+        case Hanami::PUT_TYPE:    return 3;
+        default:                  return -1;
+    }
+}
+
+}  // namespace Misaki
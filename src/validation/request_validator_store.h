@@ -0,0 +1,69 @@
+/**
+ * @file        request_validator_store.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_REQUEST_VALIDATOR_STORE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_REQUEST_VALIDATOR_STORE_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+
+#include <common/rcu_pointer.h>
+#include <validation/request_validator.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+namespace Misaki
+{
+
+class RequestValidatorStore
+{
+public:
+    static RequestValidatorStore* getInstance();
+
+    bool build(Kitsunemimi::ErrorContainer &error);
+    bool validate(const std::string &endpoint,
+                  const Kitsunemimi::Hanami::HttpRequestType httpType,
+                  const Kitsunemimi::DataMap &input,
+                  Kitsunemimi::ErrorContainer &error) const;
+
+private:
+    RequestValidatorStore();
+
+    static const uint32_t NUMBER_OF_HTTP_TYPES = 4;
+
+    struct ValidatorIndex
+    {
+        // validators are shared by all endpoints of the same blossom
+        std::vector<RequestValidator> validators;
+        std::unordered_map<std::string, std::array<int32_t, NUMBER_OF_HTTP_TYPES>> endpoints;
+    };
+
+    RcuPointer<ValidatorIndex> m_index;
+
+    static int32_t getHttpTypePos(const Kitsunemimi::Hanami::HttpRequestType httpType);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_REQUEST_VALIDATOR_STORE_H
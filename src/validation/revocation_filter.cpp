@@ -0,0 +1,511 @@
+/**
+ * @file        revocation_filter.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/revocation_filter.h>
+#include <common/digest.h>
+#include <common/misaki_call_guard.h>
+
+#include <libKitsunemimiJson/json_item.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessagingClient;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * @brief get the positions of the bits of an entry within its block. All positions are taken
+ *        from a second mix of the digest, while the block is selected by the digest itself.
+ */
+static inline uint64_t
+getBitSource(const uint64_t digest)
+{
+    uint64_t mixed = digest * 0x9E3779B97F4A7C15ULL;
+    mixed ^= mixed >> 29;
+    return mixed;
+}
+
+/**
+ * @brief create new bloom-filter for all ids of the set with around 10 bits per entry
+ */
+void
+RevocationFilter::RevocationSet::buildFilter()
+{
+    const uint64_t requiredBits = std::max<uint64_t>(revocationIds.size() * 10, 512);
+
+    uint64_t numberOfBlocks = 1;
+    while(numberOfBlocks * 512 < requiredBits) {
+        numberOfBlocks *= 2;
+    }
+
+    // value-initialized, so all bits are zero
+    blocks.assign(numberOfBlocks, FilterBlock());
+    blockMask = numberOfBlocks - 1;
+
+    for(const std::string &revocationId : revocationIds)
+    {
+        const uint64_t digest = calcDigest(revocationId);
+        FilterBlock &block = blocks[digest & blockMask];
+        uint64_t bitSource = getBitSource(digest);
+        for(uint32_t i = 0; i < NUMBER_OF_PROBES; i++)
+        {
+            const uint32_t bit = bitSource & 511;
+            block.words[bit / 64] |= 1ULL << (bit % 64);
+            bitSource >>= 9;
+        }
+    }
+}
+
+/**
+ * @brief check the bloom-filter
+ *
+ * @param digest digest of the revocation-id
+ *
+ * @return false, if the id is definitely not in the set, else true
+ */
+bool
+RevocationFilter::RevocationSet::mayContain(const uint64_t digest) const
+{
+    const FilterBlock &block = blocks[digest & blockMask];
+    uint64_t bitSource = getBitSource(digest);
+    for(uint32_t i = 0; i < NUMBER_OF_PROBES; i++)
+    {
+        const uint32_t bit = bitSource & 511;
+        if((block.words[bit / 64] & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+        bitSource >>= 9;
+    }
+
+    return true;
+}
+
+/**
+ * @brief constructor
+ */
+RevocationFilter::RevocationFilter()
+    : Kitsunemimi::Thread("Misaki_RevocationFilter")
+{
+    m_intervalSec = 10;
+    m_isPulling = false;
+
+    RevocationSet* emptySet = new RevocationSet();
+    emptySet->buildFilter();
+    m_revocationSet.publish(emptySet);
+}
+
+/**
+ * @brief get instance of the revocation-filter
+ *
+ * @return pointer to the static instance
+ */
+RevocationFilter*
+RevocationFilter::getInstance()
+{
+    static RevocationFilter instance;
+    return &instance;
+}
+
+/**
+ * @brief check if a token was revoked
+ *
+ * @param revocationId jti-claim of the token or the token itself
+ *
+ * @return true, if revoked, else false
+ */
+bool
+RevocationFilter::isRevoked(const std::string &revocationId) const
+{
+    const RcuPointer<RevocationSet>::ReadGuard revocationSet = m_revocationSet.read();
+    if(revocationSet->revocationIds.size() == 0) {
+        return false;
+    }
+
+    if(revocationSet->mayContain(calcDigest(revocationId)) == false) {
+        return false;
+    }
+
+    return revocationSet->revocationIds.count(revocationId) > 0;
+}
+
+/**
+ * @brief read a version-number from a delta
+ *
+ * @param version reference for the result
+ * @param delta parsed delta
+ * @param key name of the field
+ * @param error reference for error-output
+ *
+ * @return false, if the field is missing or not a positive number, else true
+ */
+static bool
+getVersionField(uint64_t &version,
+                const JsonItem &delta,
+                const std::string &key,
+                ErrorContainer &error)
+{
+    if(delta.isMap() == false
+            || delta.contains(key) == false
+            || delta.get(key).isInteger() == false
+            || delta.get(key).getLong() < 0)
+    {
+        error.addMeesage("Delta of the revoked jwt-tokens has no valid field '" + key + "'");
+        return false;
+    }
+
+    version = static_cast<uint64_t>(delta.get(key).getLong());
+    return true;
+}
+
+/**
+ * @brief apply changes of the revocations. The delta has the form
+ *        {"version": <N>, "base_version": <N>, "full": <BOOL>, "revoked": [<IDs>],
+ *        "unrevoked": [<IDs>]}. If full is true, the delta contains all revocations and replaces
+ *        the old set. Otherwise it contains the changes from base_version to version and is
+ *        only applied on top of exactly base_version. Without base_version, the delta contains
+ *        the changes of a single version. Revocations of expired tokens are removed by misaki
+ *        with the unrevoked-list.
+ *
+ *        If versions are missing between the actual set and the delta, the delta is rejected
+ *        and the missing changes are pulled from misaki instead.
+ *
+ * @param deltaJson delta as json-string
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationFilter::applyDelta(const std::string &deltaJson,
+                             ErrorContainer &error)
+{
+    JsonItem delta;
+    if(delta.parse(deltaJson, error) == false)
+    {
+        error.addMeesage("Failed to parse delta of the revoked jwt-tokens");
+        return false;
+    }
+
+    uint64_t version = 0;
+    if(getVersionField(version, delta, "version", error) == false) {
+        return false;
+    }
+
+    uint64_t baseVersion = version > 0 ? version - 1 : 0;
+    if(delta.contains("base_version")
+            && getVersionField(baseVersion, delta, "base_version", error) == false)
+    {
+        return false;
+    }
+
+    bool hasGap = false;
+    if(applyChanges(hasGap, delta, version, baseVersion, error)) {
+        return true;
+    }
+    if(hasGap == false) {
+        return false;
+    }
+
+    LOG_WARNING("Delta of the revoked jwt-tokens with version " + std::to_string(version)
+                + " doesn't follow the actual version, so the changes are pulled from misaki");
+
+    return pullFromMisaki(error);
+}
+
+/**
+ * @brief apply a parsed delta to the actual set of revocations
+ *
+ * @param hasGap reference, which is set to true, if the delta doesn't start at the actual version
+ * @param delta parsed delta
+ * @param version version after the delta
+ * @param baseVersion version, on which an incremental delta is based
+ * @param error reference for error-output
+ *
+ * @return true, if successful or already applied, else false
+ */
+bool
+RevocationFilter::applyChanges(bool &hasGap,
+                               const JsonItem &delta,
+                               const uint64_t version,
+                               const uint64_t baseVersion,
+                               ErrorContainer &error)
+{
+    hasGap = false;
+    const bool isFull = delta.contains("full") && delta.get("full").getBool();
+
+    std::lock_guard<std::mutex> guard(m_updateLock);
+
+    RevocationSet* newSet = new RevocationSet();
+    newSet->version = version;
+    {
+        const RcuPointer<RevocationSet>::ReadGuard oldSet = m_revocationSet.read();
+        if(isFull)
+        {
+            if(version < oldSet->version)
+            {
+                delete newSet;
+                error.addMeesage("Full delta of the revoked jwt-tokens with version "
+                                 + std::to_string(version)
+                                 + " is older than the actual version "
+                                 + std::to_string(oldSet->version));
+                return false;
+            }
+        }
+        else
+        {
+            // deltas, which are already applied, are skipped
+            if(version <= oldSet->version)
+            {
+                delete newSet;
+                return true;
+            }
+
+            if(baseVersion != oldSet->version)
+            {
+                delete newSet;
+                hasGap = true;
+                error.addMeesage("Delta of the revoked jwt-tokens is based on version "
+                                 + std::to_string(baseVersion)
+                                 + ", but the actual version is "
+                                 + std::to_string(oldSet->version));
+                return false;
+            }
+
+            newSet->revocationIds = oldSet->revocationIds;
+        }
+    }
+
+    JsonItem revoked = delta.get("revoked");
+    for(uint64_t i = 0; i < revoked.size(); i++) {
+        newSet->revocationIds.insert(revoked.get(i).getString());
+    }
+    JsonItem unrevoked = delta.get("unrevoked");
+    for(uint64_t i = 0; i < unrevoked.size(); i++) {
+        newSet->revocationIds.erase(unrevoked.get(i).getString());
+    }
+
+    // a bloom-filter can not remove entries, so it is always build again
+    newSet->buildFilter();
+    m_revocationSet.publish(newSet);
+
+    return true;
+}
+
+/**
+ * @brief send the request for all changes since a version to misaki
+ *
+ * @param responseContent reference for the content of the response
+ * @param sinceVersion version of the local set
+ * @param error reference for error-output
+ *
+ * @return MISAKI_CALL_OK, if successful, MISAKI_CALL_UNREACHABLE, if misaki could not be
+ *         reached, else MISAKI_CALL_REJECTED
+ */
+static MisakiCallResult
+requestDelta(std::string &responseContent,
+             const uint64_t sinceVersion,
+             ErrorContainer &error)
+{
+    HanamiMessagingClient* misakiClient = HanamiMessaging::getInstance()->misakiClient;
+    Hanami::ResponseMessage response;
+
+    // create request
+    Hanami::RequestMessage request;
+    request.id = "v1/token/revocations";
+    request.httpType = Hanami::GET_TYPE;
+    request.inputValues = "{\"since_version\":" + std::to_string(sinceVersion) + "}";
+
+    // request delta from misaki
+    if(misakiClient->triggerSakuraFile(response, request, error) == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get the revoked jwt-tokens");
+        return MISAKI_CALL_UNREACHABLE;
+    }
+
+    // check response
+    if(response.success == false)
+    {
+        error.addMeesage("Failed to trigger misaki to get the revoked jwt-tokens (no success)");
+        return MISAKI_CALL_REJECTED;
+    }
+
+    responseContent = response.responseContent;
+
+    return MISAKI_CALL_OK;
+}
+
+/**
+ * @brief request all changes since the actual version from misaki. The request is protected
+ *        by the deadline, the retries and the circuit-breaker of the misaki-call-guard.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationFilter::pullFromMisaki(ErrorContainer &error)
+{
+    const uint64_t sinceVersion = getVersion();
+
+    std::string responseContent;
+    MisakiCallGuard* callGuard = MisakiCallGuard::getInstance();
+    const MisakiCallResult callResult = callGuard->call(
+                [&responseContent, sinceVersion](ErrorContainer &callError)
+    {
+        return requestDelta(responseContent, sinceVersion, callError);
+    },
+    callGuard->getDeadline(),
+    error);
+    if(callResult != MISAKI_CALL_OK) {
+        return false;
+    }
+
+    JsonItem delta;
+    if(delta.parse(responseContent, error) == false)
+    {
+        error.addMeesage("Failed to parse delta of the revoked jwt-tokens");
+        return false;
+    }
+
+    // the response contains all changes since the requested version
+    uint64_t version = 0;
+    uint64_t baseVersion = sinceVersion;
+    if(getVersionField(version, delta, "version", error) == false
+            || (delta.contains("base_version")
+                && getVersionField(baseVersion, delta, "base_version", error) == false))
+    {
+        return false;
+    }
+
+    bool hasGap = false;
+    return applyChanges(hasGap, delta, version, baseVersion, error);
+}
+
+/**
+ * @brief load the revocations once and start a thread, which pulls the changes periodically.
+ *        If the thread is already running, only the interval is updated.
+ *
+ * @param intervalSec time in seconds between two requests to misaki (1 - 86400)
+ * @param error reference for error-output
+ *
+ * @return false, if the initial load failed or the thread can not be started, else true
+ */
+bool
+RevocationFilter::startPulling(const uint32_t intervalSec,
+                               ErrorContainer &error)
+{
+    if(pullFromMisaki(error) == false) {
+        return false;
+    }
+
+    uint32_t clampedIntervalSec = std::max<uint32_t>(intervalSec, 1);
+    if(clampedIntervalSec > MAX_PULL_INTERVAL) {
+        clampedIntervalSec = MAX_PULL_INTERVAL;
+    }
+    m_intervalSec = clampedIntervalSec;
+
+    bool expected = false;
+    if(m_isPulling.compare_exchange_strong(expected, true) == false) {
+        return true;
+    }
+
+    if(startThread() == false)
+    {
+        m_isPulling = false;
+        error.addMeesage("Failed to start thread to pull the revoked jwt-tokens");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief stop the thread, which pulls the changes, and wait until it is finished
+ */
+void
+RevocationFilter::stopPulling()
+{
+    if(m_isPulling == false) {
+        return;
+    }
+
+    stopThread();
+    m_isPulling = false;
+}
+
+/**
+ * @brief get version of the last applied delta
+ *
+ * @return version of the revocation-set
+ */
+uint64_t
+RevocationFilter::getVersion() const
+{
+    return m_revocationSet.read()->version;
+}
+
+/**
+ * @brief get number of revoked tokens
+ *
+ * @return number of revocation-ids
+ */
+uint64_t
+RevocationFilter::size() const
+{
+    return m_revocationSet.read()->revocationIds.size();
+}
+
+/**
+ * @brief loop, which pulls the changes of the revocations. If misaki is not reachable, the
+ *        old set stays active.
+ */
+void
+RevocationFilter::run()
+{
+    while(m_abort == false)
+    {
+        // sleep in steps of one second, so a stop doesn't have to wait for the whole interval
+        uint32_t sleptSec = 0;
+        while(sleptSec < m_intervalSec
+              && m_abort == false)
+        {
+            sleepThread(1000000);
+            sleptSec++;
+        }
+        if(m_abort) {
+            break;
+        }
+
+        ErrorContainer error;
+        if(pullFromMisaki(error) == false)
+        {
+            error.addMeesage("Failed to update revoked jwt-tokens");
+            LOG_ERROR(error);
+        }
+    }
+
+    m_isPulling = false;
+}
+
+}  // namespace Misaki
@@ -0,0 +1,106 @@
+/**
+ * @file        revocation_filter.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_REVOCATION_FILTER_H
+#define KITSUNEMIMI_HANAMI_MISAKI_REVOCATION_FILTER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
+
+#include <common/rcu_pointer.h>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiCommon/threading/thread.h>
+#include <libKitsunemimiJson/json_item.h>
+
+namespace Misaki
+{
+
+/**
+ * Set of revoked tokens. A blocked bloom-filter, where all bits of an entry are within a
+ * single cache-line, answers most checks with one memory-access. Only hits of the filter are
+ * confirmed by the exact set.
+ *
+ * Revocations are identified by the jti-claim of the token or, if the token has no jti-claim,
+ * by the complete token.
+ */
+class RevocationFilter
+        : public Kitsunemimi::Thread
+{
+public:
+    static RevocationFilter* getInstance();
+
+    bool isRevoked(const std::string &revocationId) const;
+    bool applyDelta(const std::string &deltaJson,
+                    Kitsunemimi::ErrorContainer &error);
+    bool pullFromMisaki(Kitsunemimi::ErrorContainer &error);
+    bool startPulling(const uint32_t intervalSec,
+                      Kitsunemimi::ErrorContainer &error);
+    void stopPulling();
+
+    uint64_t getVersion() const;
+    uint64_t size() const;
+
+protected:
+    void run();
+
+private:
+    RevocationFilter();
+
+    static const uint32_t NUMBER_OF_PROBES = 7;
+    static const uint32_t MAX_PULL_INTERVAL = 86400;
+
+    struct alignas(64) FilterBlock
+    {
+        uint64_t words[8];
+    };
+
+    struct RevocationSet
+    {
+        uint64_t version = 0;
+        std::unordered_set<std::string> revocationIds;
+        std::vector<FilterBlock> blocks;
+        uint64_t blockMask = 0;
+
+        void buildFilter();
+        bool mayContain(const uint64_t digest) const;
+    };
+
+    bool applyChanges(bool &hasGap,
+                      const Kitsunemimi::JsonItem &delta,
+                      const uint64_t version,
+                      const uint64_t baseVersion,
+                      Kitsunemimi::ErrorContainer &error);
+
+    RcuPointer<RevocationSet> m_revocationSet;
+    std::mutex m_updateLock;
+    std::atomic<uint32_t> m_intervalSec;
+    std::atomic<bool> m_isPulling;
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_REVOCATION_FILTER_H
@@ -0,0 +1,231 @@
+/**
+ * @file        token_validator.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/token_validator.h>
+#include <validation/verified_token_cache.h>
+#include <validation/key_store.h>
+#include <validation/revocation_filter.h>
+#include <token/jwt_helper.h>
+
+#include <libKitsunemimiCommon/methods/string_methods.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief constructor
+ */
+TokenValidator::TokenValidator() {}
+
+/**
+ * @brief get instance of the token-validator
+ *
+ * @return pointer to the static instance
+ */
+TokenValidator*
+TokenValidator::getInstance()
+{
+    static TokenValidator instance;
+    return &instance;
+}
+
+/**
+ * @brief set or replace the key, which is used to check the signature of tokens without
+ *        kid-header
+ *
+ * @param tokenKey key, which was used by misaki to sign the tokens
+ * @param error reference for error-output
+ *
+ * @return false, if key is invalid, else true
+ */
+bool
+TokenValidator::setKey(const std::string &tokenKey,
+                       ErrorContainer &error)
+{
+    const std::map<std::string, std::string> keys = {{"", tokenKey}};
+    return KeyStore::getInstance()->setKeys(keys, error);
+}
+
+/**
+ * @brief check if a key for the validation was set
+ *
+ * @return true, if key is set, else false
+ */
+bool
+TokenValidator::isInitialized() const
+{
+    return KeyStore::getInstance()->hasKeys();
+}
+
+/**
+ * @brief validate a jwt-token without asking misaki
+ *
+ * @param claims reference for the claims of the validated token, which are shared with the
+ *               cache of verified tokens
+ * @param token jwt-token to validate
+ * @param error reference for error-output
+ *
+ * @return true, if the token is valid, else false
+ */
+bool
+TokenValidator::validate(TokenClaimsPtr &claims,
+                         const std::string &token,
+                         ErrorContainer &error)
+{
+    // revocations can happen after a token was cached, so they are also checked for cache-hits
+    VerifiedTokenCache* verifiedTokenCache = VerifiedTokenCache::getInstance();
+    if(verifiedTokenCache->get(claims, token))
+    {
+        if(isRevoked(*claims, token))
+        {
+            error.addMeesage("Jwt-token was revoked");
+            return false;
+        }
+        return true;
+    }
+
+    JsonItem payload;
+    uint64_t keyGeneration = 0;
+
+    // check signature
+    if(KeyStore::getInstance()->validateSignature(payload, keyGeneration, token, error) == false) {
+        return false;
+    }
+
+    std::shared_ptr<TokenClaims> newClaims = std::make_shared<TokenClaims>();
+    if(readClaims(*newClaims, payload, error) == false) {
+        return false;
+    }
+
+    // check time-range, where the token is valid
+    const long now = getCurrentUnixTime();
+    if(newClaims->expireTime <= now)
+    {
+        error.addMeesage("Jwt-token is expired");
+        return false;
+    }
+    if(payload.contains("nbf")
+            && payload.get("nbf").getLong() > now)
+    {
+        error.addMeesage("Jwt-token is not valid yet");
+        return false;
+    }
+
+    if(isRevoked(*newClaims, token))
+    {
+        error.addMeesage("Jwt-token was revoked");
+        return false;
+    }
+
+    claims = newClaims;
+    verifiedTokenCache->add(token, claims, keyGeneration);
+
+    return true;
+}
+
+/**
+ * @brief check if a token is within the revocation-filter
+ *
+ * @param claims claims of the token
+ * @param token jwt-token to check
+ *
+ * @return true, if revoked, else false
+ */
+bool
+TokenValidator::isRevoked(const TokenClaims &claims,
+                          const std::string &token)
+{
+    if(claims.tokenId.size() > 0) {
+        return RevocationFilter::getInstance()->isRevoked(claims.tokenId);
+    }
+
+    return RevocationFilter::getInstance()->isRevoked(token);
+}
+
+/**
+ * @brief convert the payload of a token into the claims-struct
+ *
+ * @param claims reference for the resulting claims
+ * @param payload payload of the token
+ * @param error reference for error-output
+ *
+ * @return false, if a required claim is missing, else true
+ */
+bool
+TokenValidator::readClaims(TokenClaims &claims,
+                           JsonItem &payload,
+                           ErrorContainer &error)
+{
+    if(payload.contains("exp") == false)
+    {
+        error.addMeesage("Jwt-token has no exp-claim");
+        return false;
+    }
+    claims.expireTime = payload.get("exp").getLong();
+
+    // user-tokens have a name, while internal tokens only have a service-name
+    if(payload.contains("name")) {
+        claims.name = payload.get("name").getString();
+    } else if(payload.contains("service_name")) {
+        claims.name = payload.get("service_name").getString();
+    } else {
+        error.addMeesage("Jwt-token has no name- or service_name-claim");
+        return false;
+    }
+
+    if(payload.contains("jti")) {
+        claims.tokenId = payload.get("jti").getString();
+    }
+
+    if(payload.contains("uuid")) {
+        claims.userId = payload.get("uuid").getString();
+    }
+
+    if(payload.contains("is_admin")) {
+        claims.isAdmin = payload.get("is_admin").getBool();
+    }
+
+    // roles can be given as array or as comma-separated string
+    claims.roles.clear();
+    if(payload.contains("roles"))
+    {
+        JsonItem roles = payload.get("roles");
+        if(roles.isArray())
+        {
+            for(uint64_t i = 0; i < roles.size(); i++) {
+                claims.roles.push_back(roles.get(i).getString());
+            }
+        }
+        else
+        {
+            splitStringByDelimiter(claims.roles, roles.getString(), ',');
+        }
+    }
+
+    claims.payload = payload;
+
+    return true;
+}
+
+}  // namespace Misaki
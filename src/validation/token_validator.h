@@ -0,0 +1,61 @@
+/**
+ * @file        token_validator.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_TOKEN_VALIDATOR_H
+#define KITSUNEMIMI_HANAMI_MISAKI_TOKEN_VALIDATOR_H
+
+#include <string>
+
+#include <libMisakiGuard/misaki_input.h>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiJson/json_item.h>
+
+namespace Misaki
+{
+
+class TokenValidator
+{
+public:
+    static TokenValidator* getInstance();
+
+    bool setKey(const std::string &tokenKey,
+                Kitsunemimi::ErrorContainer &error);
+    bool isInitialized() const;
+    bool validate(TokenClaimsPtr &claims,
+                  const std::string &token,
+                  Kitsunemimi::ErrorContainer &error);
+
+    static bool readClaims(TokenClaims &claims,
+                           Kitsunemimi::JsonItem &payload,
+                           Kitsunemimi::ErrorContainer &error);
+
+private:
+    TokenValidator();
+
+    static bool isRevoked(const TokenClaims &claims,
+                          const std::string &token);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_TOKEN_VALIDATOR_H
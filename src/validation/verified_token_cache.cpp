@@ -0,0 +1,254 @@
+/**
+ * @file        verified_token_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <validation/verified_token_cache.h>
+#include <token/jwt_helper.h>
+#include <common/digest.h>
+
+#include <thread>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief get number of shards, which is the number of cpu-threads, rounded up to the next
+ *        power of two, so concurrent lookups are spread over multiple locks
+ *
+ * @return number of shards
+ */
+static uint64_t
+getNumberOfShards()
+{
+    uint64_t numberOfShards = 8;
+    while(numberOfShards < std::thread::hardware_concurrency()
+          && numberOfShards < 256)
+    {
+        numberOfShards *= 2;
+    }
+
+    return numberOfShards;
+}
+
+/**
+ * @brief constructor
+ */
+VerifiedTokenCache::VerifiedTokenCache()
+    : m_shards(getNumberOfShards())
+{
+    m_shardMask = m_shards.size() - 1;
+    m_maxEntriesPerShard = 100000 / m_shards.size();
+}
+
+/**
+ * @brief get instance of the cache
+ *
+ * @return pointer to the static instance
+ */
+VerifiedTokenCache*
+VerifiedTokenCache::getInstance()
+{
+    static VerifiedTokenCache instance;
+    return &instance;
+}
+
+/**
+ * @brief get claims of an already verified token
+ *
+ * @param claims reference for the resulting claims, which are shared with the cache
+ * @param token raw jwt-token
+ *
+ * @return true, if the token was found, is not expired and was verified with the actual keys,
+ *         else false
+ */
+bool
+VerifiedTokenCache::get(TokenClaimsPtr &claims,
+                        const std::string &token)
+{
+    const uint64_t digest = calcDigest(token);
+    Shard* shard = getShard(digest);
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    const auto it = shard->entries.find(digest);
+    if(it == shard->entries.end())
+    {
+        shard->misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // compare full token to be safe against collisions of the digest
+    std::list<CacheEntry>::iterator entry = it->second;
+    if(entry->token != token)
+    {
+        shard->misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // remove expired tokens and tokens, which were verified with an old set of keys
+    if(entry->claims->expireTime <= getCurrentUnixTime()
+            || entry->keyGeneration != m_keyGeneration.load())
+    {
+        shard->lruList.erase(entry);
+        shard->entries.erase(it);
+        shard->misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // move entry to the front of the lru-list
+    shard->lruList.splice(shard->lruList.begin(), shard->lruList, entry);
+    claims = entry->claims;
+    shard->hits.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+/**
+ * @brief add a verified token to the cache
+ *
+ * @param token raw jwt-token
+ * @param claims claims of the token
+ * @param keyGeneration generation of the key-set, which was used to verify the token
+ */
+void
+VerifiedTokenCache::add(const std::string &token,
+                        const TokenClaimsPtr &claims,
+                        const uint64_t keyGeneration)
+{
+    const uint64_t digest = calcDigest(token);
+    Shard* shard = getShard(digest);
+    const uint64_t maxEntries = m_maxEntriesPerShard.load(std::memory_order_relaxed);
+    if(maxEntries == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    // a validation, which was still running while the keys were replaced, must not add its
+    // result after the cache was cleared
+    if(keyGeneration != m_keyGeneration.load()) {
+        return;
+    }
+
+    // replace old entry, which has the same digest
+    const auto it = shard->entries.find(digest);
+    if(it != shard->entries.end())
+    {
+        shard->lruList.erase(it->second);
+        shard->entries.erase(it);
+    }
+
+    // evict least recently used entries
+    while(shard->lruList.size() >= maxEntries)
+    {
+        shard->entries.erase(shard->lruList.back().digest);
+        shard->lruList.pop_back();
+        shard->evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    CacheEntry entry;
+    entry.digest = digest;
+    entry.token = token;
+    entry.keyGeneration = keyGeneration;
+    entry.claims = claims;
+    shard->lruList.push_front(entry);
+    shard->entries.emplace(digest, shard->lruList.begin());
+}
+
+/**
+ * @brief switch to a new generation of keys and remove all tokens, which were verified with
+ *        the old keys
+ *
+ * @param keyGeneration generation of the new key-set
+ */
+void
+VerifiedTokenCache::setKeyGeneration(const uint64_t keyGeneration)
+{
+    // set the generation first, so entries, which are added while clearing, are rejected
+    m_keyGeneration = keyGeneration;
+    clear();
+}
+
+/**
+ * @brief remove all entries from the cache
+ */
+void
+VerifiedTokenCache::clear()
+{
+    for(Shard &shard : m_shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.entries.clear();
+        shard.lruList.clear();
+    }
+}
+
+/**
+ * @brief set maximum number of cached tokens
+ *
+ * @param maxNumberOfEntries new maximum, which is split over all shards. 0 disables the cache.
+ */
+void
+VerifiedTokenCache::setMaxNumberOfEntries(const uint64_t maxNumberOfEntries)
+{
+    uint64_t perShard = maxNumberOfEntries / m_shards.size();
+    if(maxNumberOfEntries != 0
+            && perShard == 0)
+    {
+        perShard = 1;
+    }
+    m_maxEntriesPerShard = perShard;
+}
+
+/**
+ * @brief get counters of the cache
+ *
+ * @param stats reference for the resulting counters
+ */
+void
+VerifiedTokenCache::getStats(VerifiedTokenCacheStats &stats) const
+{
+    stats = VerifiedTokenCacheStats();
+    for(const Shard &shard : m_shards)
+    {
+        stats.hits += shard.hits.load(std::memory_order_relaxed);
+        stats.misses += shard.misses.load(std::memory_order_relaxed);
+        stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief get shard for a digest
+ *
+ * @param digest digest of the token
+ *
+ * @return pointer to the shard
+ */
+VerifiedTokenCache::Shard*
+VerifiedTokenCache::getShard(const uint64_t digest)
+{
+    // the lower bits are used by the unordered_map, so the shard is selected by the upper bits
+    return &m_shards[(digest >> 48) & m_shardMask];
+}
+
+}  // namespace Misaki
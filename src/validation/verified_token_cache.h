@@ -0,0 +1,85 @@
+/**
+ * @file        verified_token_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_VERIFIED_TOKEN_CACHE_H
+#define KITSUNEMIMI_HANAMI_MISAKI_VERIFIED_TOKEN_CACHE_H
+
+#include <string>
+#include <list>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+#include <libMisakiGuard/misaki_input.h>
+
+namespace Misaki
+{
+
+class VerifiedTokenCache
+{
+public:
+    static VerifiedTokenCache* getInstance();
+
+    bool get(TokenClaimsPtr &claims,
+             const std::string &token);
+    void add(const std::string &token,
+             const TokenClaimsPtr &claims,
+             const uint64_t keyGeneration);
+    void setKeyGeneration(const uint64_t keyGeneration);
+    void clear();
+
+    void setMaxNumberOfEntries(const uint64_t maxNumberOfEntries);
+    void getStats(VerifiedTokenCacheStats &stats) const;
+
+private:
+    VerifiedTokenCache();
+
+    struct CacheEntry
+    {
+        uint64_t digest = 0;
+        std::string token = "";
+        uint64_t keyGeneration = 0;
+        TokenClaimsPtr claims;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex lock;
+        std::list<CacheEntry> lruList;
+        std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> entries;
+        std::atomic<uint64_t> hits {0};
+        std::atomic<uint64_t> misses {0};
+        std::atomic<uint64_t> evictions {0};
+    };
+
+    std::vector<Shard> m_shards;
+    uint64_t m_shardMask = 0;
+    std::atomic<uint64_t> m_maxEntriesPerShard;
+    std::atomic<uint64_t> m_keyGeneration {0};
+
+    Shard* getShard(const uint64_t digest);
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_VERIFIED_TOKEN_CACHE_H
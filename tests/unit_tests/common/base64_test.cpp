@@ -0,0 +1,231 @@
+/**
+ * @file        base64_test.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "base64_test.h"
+
+#include <random>
+#include <vector>
+
+#include <common/base64.h>
+
+#include <libKitsunemimiCrypto/common.h>
+
+namespace Misaki
+{
+
+/**
+ * @brief create random data
+ */
+static std::string
+createRandomData(std::mt19937_64 &random,
+                 const uint64_t size)
+{
+    std::string data(size, '\0');
+    for(char &c : data) {
+        c = static_cast<char>(random() & 0xFF);
+    }
+    return data;
+}
+
+/**
+ * @brief convert the output of the existing encoder into base64url without padding
+ */
+static std::string
+convertToBase64Url(const std::string &base64)
+{
+    std::string result = base64;
+    while(result.size() > 0
+          && result.back() == '=')
+    {
+        result.pop_back();
+    }
+    for(char &c : result)
+    {
+        if(c == '+') {
+            c = '-';
+        } else if(c == '/') {
+            c = '_';
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief check if a string is decoded successfully by the active kernel
+ */
+static bool
+decode(std::string &result,
+       const std::string &input,
+       const Base64Alphabet alphabet = BASE64_STANDARD)
+{
+    result.clear();
+    return appendDecodedBase64(result, input.c_str(), input.size(), alphabet);
+}
+
+/**
+ * @brief constructor
+ */
+Base64_Test::Base64_Test()
+    : Kitsunemimi::CompareTestHelper("Base64_Test")
+{
+    // each test runs with all kernels, which are supported by the cpu
+    const Base64Kernel bestKernel = getBestBase64Kernel();
+    for(uint32_t i = 0; i <= bestKernel; i++)
+    {
+        TEST_EQUAL(setBase64Kernel(static_cast<Base64Kernel>(i)), true);
+
+        encode_test();
+        decode_test();
+        invalidDecode_test();
+    }
+    setBase64Kernel(bestKernel);
+}
+
+/**
+ * @brief encode_test
+ */
+void
+Base64_Test::encode_test()
+{
+    std::mt19937_64 random(42);
+
+    bool isStandardEqual = true;
+    bool isUrlEqual = true;
+    for(uint64_t size = 0; size < 1024; size++)
+    {
+        const std::string data = createRandomData(random, size);
+
+        std::string expected;
+        Kitsunemimi::encodeBase64(expected, data.c_str(), data.size());
+
+        std::string encoded;
+        appendBase64(encoded, data.c_str(), data.size(), BASE64_STANDARD);
+        isStandardEqual = isStandardEqual && encoded == expected;
+
+        std::string encodedUrl;
+        appendBase64(encodedUrl, data.c_str(), data.size(), BASE64_URL);
+        isUrlEqual = isUrlEqual && encodedUrl == convertToBase64Url(expected);
+    }
+
+    TEST_EQUAL(isStandardEqual, true);
+    TEST_EQUAL(isUrlEqual, true);
+
+    // output is appended to existing content
+    std::string output = "prefix:";
+    appendBase64(output, "ab", 2);
+    TEST_EQUAL(output, std::string("prefix:YWI="));
+}
+
+/**
+ * @brief decode_test
+ */
+void
+Base64_Test::decode_test()
+{
+    std::mt19937_64 random(1337);
+
+    bool isStandardEqual = true;
+    bool isUrlEqual = true;
+    for(uint64_t size = 0; size < 1024; size++)
+    {
+        const std::string data = createRandomData(random, size);
+
+        std::string encoded;
+        Kitsunemimi::encodeBase64(encoded, data.c_str(), data.size());
+
+        std::string decoded;
+        isStandardEqual = isStandardEqual
+                          && decode(decoded, encoded, BASE64_STANDARD)
+                          && decoded == data;
+
+        isUrlEqual = isUrlEqual
+                     && decode(decoded, convertToBase64Url(encoded), BASE64_URL)
+                     && decoded == data;
+    }
+
+    TEST_EQUAL(isStandardEqual, true);
+    TEST_EQUAL(isUrlEqual, true);
+
+    // padding is optional
+    std::string decoded;
+    TEST_EQUAL(decode(decoded, "QQ=="), true);
+    TEST_EQUAL(decoded, std::string("A"));
+    TEST_EQUAL(decode(decoded, "QQ"), true);
+    TEST_EQUAL(decoded, std::string("A"));
+    TEST_EQUAL(decode(decoded, "QUI="), true);
+    TEST_EQUAL(decoded, std::string("AB"));
+    TEST_EQUAL(decode(decoded, "QUI"), true);
+    TEST_EQUAL(decoded, std::string("AB"));
+    TEST_EQUAL(decode(decoded, ""), true);
+    TEST_EQUAL(decoded, std::string(""));
+}
+
+/**
+ * @brief invalidDecode_test
+ */
+void
+Base64_Test::invalidDecode_test()
+{
+    // long prefix, so the invalid part is also checked after the vectorized kernels
+    std::string prefix = "";
+    for(uint32_t i = 0; i < 32; i++) {
+        prefix += "QUJD";
+    }
+
+    const std::vector<std::string> invalidInputs = {
+        // padding, which doesn't complete the last block
+        "QQ=",
+        "QUJD=",
+        "QUJDQQ=",
+        "Q===",
+        "====",
+        // unused bits of the last character are not zero
+        "QR==",
+        "QR",
+        "QUJ=",
+        "QUJ",
+        // single remaining character
+        "Q",
+        // invalid characters
+        "QU*D",
+        "QU-D",
+    };
+
+    std::string decoded;
+    for(const std::string &input : invalidInputs)
+    {
+        TEST_EQUAL(decode(decoded, input), false);
+        TEST_EQUAL(decode(decoded, prefix + input), false);
+    }
+
+    // characters of the other alphabet
+    TEST_EQUAL(decode(decoded, "QU_D", BASE64_URL), true);
+    TEST_EQUAL(decode(decoded, "QU/D", BASE64_URL), false);
+
+    // failed decoding keeps the existing content
+    std::string output = "prefix";
+    TEST_EQUAL(appendDecodedBase64(output, "QQ=", 3), false);
+    TEST_EQUAL(output, std::string("prefix"));
+}
+
+}  // namespace Misaki
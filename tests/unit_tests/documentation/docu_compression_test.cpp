@@ -0,0 +1,238 @@
+/**
+ * @file        docu_compression_test.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "docu_compression_test.h"
+
+#include <random>
+#include <vector>
+
+#include <documentation/docu_compression.h>
+
+#include <zlib.h>
+#include <zstd.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief get inputs of different sizes, with and without redundancy
+ */
+static std::vector<std::string>
+getTestInputs()
+{
+    std::vector<std::string> inputs;
+    inputs.push_back("");
+    inputs.push_back("a");
+    inputs.push_back("Request-Parameter\n~~~~~~~~~~~~~~~~~\n");
+
+    // redundant text like a rendered documentation
+    std::string text;
+    while(text.size() < 1024 * 1024) {
+        text.append("    **Type:**\n        ``String``\n    **Required:**\n        ``True``\n");
+    }
+    inputs.push_back(text);
+
+    // random data, which can not be compressed
+    std::mt19937_64 random(42);
+    std::string data(256 * 1024, '\0');
+    for(char &c : data) {
+        c = static_cast<char>(random() & 0xFF);
+    }
+    inputs.push_back(data);
+
+    return inputs;
+}
+
+/**
+ * @brief decompress a gzip-document
+ */
+static bool
+decompressGzip(std::string &output,
+               const std::string &input)
+{
+    z_stream stream = {};
+
+    // 16 added to the window-bits only accepts the gzip-format
+    if(inflateInit2(&stream, 15 + 16) != Z_OK) {
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+
+    char buffer[64 * 1024];
+    int ret = Z_OK;
+    while(ret == Z_OK)
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        ret = inflate(&stream, Z_NO_FLUSH);
+        output.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+
+    return ret == Z_STREAM_END;
+}
+
+/**
+ * @brief decompress a zstd-document
+ */
+static bool
+decompressZstd(std::string &output,
+               const std::string &input)
+{
+    const unsigned long long size = ZSTD_getFrameContentSize(input.data(), input.size());
+    if(size == ZSTD_CONTENTSIZE_UNKNOWN
+            || size == ZSTD_CONTENTSIZE_ERROR)
+    {
+        return false;
+    }
+
+    output.resize(size);
+    const size_t ret = ZSTD_decompress(&output[0], output.size(), input.data(), input.size());
+    if(ZSTD_isError(ret)) {
+        return false;
+    }
+    output.resize(ret);
+
+    return true;
+}
+
+/**
+ * @brief constructor
+ */
+DocuCompression_Test::DocuCompression_Test()
+    : Kitsunemimi::CompareTestHelper("DocuCompression_Test")
+{
+    getDocuCompression_test();
+    gzipRoundTrip_test();
+    zstdRoundTrip_test();
+    noCompression_test();
+}
+
+/**
+ * @brief getDocuCompression_test
+ */
+void
+DocuCompression_Test::getDocuCompression_test()
+{
+    TEST_EQUAL(getDocuCompression("none"), NO_DOCU_COMPRESSION);
+    TEST_EQUAL(getDocuCompression("gzip"), GZIP_DOCU_COMPRESSION);
+    TEST_EQUAL(getDocuCompression("zstd"), ZSTD_DOCU_COMPRESSION);
+    TEST_EQUAL(getDocuCompression("brotli"), UNKNOWN_DOCU_COMPRESSION);
+    TEST_EQUAL(getDocuCompression(""), UNKNOWN_DOCU_COMPRESSION);
+}
+
+/**
+ * @brief gzipRoundTrip_test
+ */
+void
+DocuCompression_Test::gzipRoundTrip_test()
+{
+    // fast and strong level
+    for(const bool preferSpeed : {false, true})
+    {
+        for(const std::string &input : getTestInputs())
+        {
+            ErrorContainer error;
+            std::string compressed;
+            const bool success = compressDocu(compressed,
+                                              input,
+                                              GZIP_DOCU_COMPRESSION,
+                                              preferSpeed,
+                                              error);
+            TEST_EQUAL(success, true);
+
+            // gzip-header
+            const bool hasGzipHeader = compressed.size() >= 2
+                                       && static_cast<uint8_t>(compressed[0]) == 0x1F
+                                       && static_cast<uint8_t>(compressed[1]) == 0x8B;
+            TEST_EQUAL(hasGzipHeader, true);
+
+            std::string decompressed;
+            TEST_EQUAL(decompressGzip(decompressed, compressed), true);
+            TEST_EQUAL(decompressed, input);
+        }
+    }
+
+    // redundant documents become much smaller
+    const std::string text = getTestInputs().at(3);
+    ErrorContainer error;
+    std::string compressed;
+    compressDocu(compressed, text, GZIP_DOCU_COMPRESSION, false, error);
+    const bool isSmaller = compressed.size() < text.size() / 10;
+    TEST_EQUAL(isSmaller, true);
+}
+
+/**
+ * @brief zstdRoundTrip_test
+ */
+void
+DocuCompression_Test::zstdRoundTrip_test()
+{
+    // fast and strong level
+    for(const bool preferSpeed : {false, true})
+    {
+        for(const std::string &input : getTestInputs())
+        {
+            ErrorContainer error;
+            std::string compressed;
+            const bool success = compressDocu(compressed,
+                                              input,
+                                              ZSTD_DOCU_COMPRESSION,
+                                              preferSpeed,
+                                              error);
+            TEST_EQUAL(success, true);
+
+            std::string decompressed;
+            TEST_EQUAL(decompressZstd(decompressed, compressed), true);
+            TEST_EQUAL(decompressed, input);
+        }
+    }
+
+    // redundant documents become much smaller
+    const std::string text = getTestInputs().at(3);
+    ErrorContainer error;
+    std::string compressed;
+    compressDocu(compressed, text, ZSTD_DOCU_COMPRESSION, false, error);
+    const bool isSmaller = compressed.size() < text.size() / 10;
+    TEST_EQUAL(isSmaller, true);
+}
+
+/**
+ * @brief noCompression_test
+ */
+void
+DocuCompression_Test::noCompression_test()
+{
+    ErrorContainer error;
+    std::string output;
+    TEST_EQUAL(compressDocu(output, "raw document", NO_DOCU_COMPRESSION, false, error), true);
+    TEST_EQUAL(output, std::string("raw document"));
+
+    TEST_EQUAL(compressDocu(output, "raw document", UNKNOWN_DOCU_COMPRESSION, false, error),
+               false);
+}
+
+}  // namespace Misaki
@@ -0,0 +1,348 @@
+/**
+ * @file        docu_renderer_test.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "docu_renderer_test.h"
+
+#include <documentation/docu_renderer.h>
+#include <documentation/docu_stream.h>
+#include <common/base64.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+namespace Misaki
+{
+
+/**
+ * Blossom with one field of each documented kind, which is only used to fill the registry for
+ * the renderer-tests.
+ */
+class DocuTestBlossom
+        : public Hanami::Blossom
+{
+public:
+    DocuTestBlossom()
+        : Hanami::Blossom("Create test object.")
+    {
+        registerInputField("name",
+                           Hanami::SAKURA_STRING_TYPE,
+                           true,
+                           "Name of the object.");
+        addFieldRegex("name", "[a-z]+");
+        addFieldBorder("name", 4, 32);
+
+        registerInputField("count",
+                           Hanami::SAKURA_INT_TYPE,
+                           false,
+                           "Number of objects.");
+        addFieldDefault("count", new DataValue(1));
+        addFieldBorder("count", 1, 10);
+
+        registerOutputField("uuid",
+                            Hanami::SAKURA_STRING_TYPE,
+                            "UUID of the object.");
+    }
+
+protected:
+    bool runTask(Hanami::BlossomIO &,
+                 const DataMap &,
+                 Hanami::BlossomStatus &,
+                 ErrorContainer &)
+    {
+        return true;
+    }
+};
+
+// all endpoints of the tests are below this prefix, so the documents don't depend on other
+// endpoints within the registry
+static const std::string testPrefix = "v1/docu_test/";
+
+/**
+ * @brief get filter, which selects all endpoints of the tests
+ */
+static DocuFilter
+getTestFilter()
+{
+    DocuFilter filter;
+    filter.endpointPrefix = testPrefix;
+    return filter;
+}
+
+/**
+ * @brief constructor
+ */
+DocuRenderer_Test::DocuRenderer_Test()
+    : Kitsunemimi::CompareTestHelper("DocuRenderer_Test")
+{
+    HanamiMessaging* interface = HanamiMessaging::getInstance();
+    interface->addBlossom("docu_test", "test_blossom", new DocuTestBlossom());
+    interface->addEndpoint(testPrefix + "list",
+                           Hanami::GET_TYPE,
+                           Hanami::BLOSSOM_TYPE,
+                           "docu_test",
+                           "test_blossom");
+    interface->addEndpoint(testPrefix + "object",
+                           Hanami::POST_TYPE,
+                           Hanami::BLOSSOM_TYPE,
+                           "docu_test",
+                           "test_blossom");
+
+    renderRst_test();
+    renderMd_test();
+    filter_test();
+    size_test();
+    stream_test();
+}
+
+/**
+ * @brief renderRst_test
+ */
+void
+DocuRenderer_Test::renderRst_test()
+{
+    const std::string blossomPart =
+            "Create test object.\n"
+            "\n"
+            "Request-Parameter\n"
+            "~~~~~~~~~~~~~~~~~\n"
+            "\n"
+            "``count``\n"
+            "    **Description:**\n"
+            "        ``Number of objects.``\n"
+            "    **Type:**\n"
+            "        ``Int``\n"
+            "    **Required:**\n"
+            "        ``False``\n"
+            "    **Default:**\n"
+            "        ``1``\n"
+            "    **Lower border of value:**\n"
+            "        ``1``\n"
+            "    **Upper border of value:**\n"
+            "        ``10``\n"
+            "\n"
+            "``name``\n"
+            "    **Description:**\n"
+            "        ``Name of the object.``\n"
+            "    **Type:**\n"
+            "        ``String``\n"
+            "    **Required:**\n"
+            "        ``True``\n"
+            "    **Must match the regex:**\n"
+            "        ``[a-z]+``\n"
+            "    **Minimum string-length:**\n"
+            "        ``4``\n"
+            "    **Maximum string-length:**\n"
+            "        ``32``\n"
+            "\n"
+            "Response-Parameter\n"
+            "~~~~~~~~~~~~~~~~~~\n"
+            "\n"
+            "``uuid``\n"
+            "    **Description:**\n"
+            "        ``UUID of the object.``\n"
+            "    **Type:**\n"
+            "        ``String``\n";
+
+    const std::string expected =
+            "DOCU_TEST\n"
+            "=========\n"
+            "\n"
+            "v1/docu_test/list\n"
+            "-----------------\n"
+            "\n"
+            "GET\n"
+            "^^^\n"
+            "\n"
+            + blossomPart
+            + "v1/docu_test/object\n"
+              "-------------------\n"
+              "\n"
+              "POST\n"
+              "^^^^\n"
+              "\n"
+            + blossomPart;
+
+    std::string docu;
+    DocuRenderer<RstFormat>::render(docu, "docu_test", getTestFilter());
+    TEST_EQUAL(docu, expected);
+}
+
+/**
+ * @brief renderMd_test
+ */
+void
+DocuRenderer_Test::renderMd_test()
+{
+    const std::string blossomPart =
+            "Create test object.\n"
+            "\n"
+            "**Request-Parameter**\n"
+            "\n"
+            "\n"
+            "`count`\n"
+            "\n"
+            "**Description:** Number of objects.\n"
+            "\n"
+            "| attribute | value |\n"
+            "| --- | --- |\n"
+            "| *Type* | Int |\n"
+            "| *Required* | False |\n"
+            "| *Default* | 1 |\n"
+            "| *Lower border of value* | 1 |\n"
+            "| *Upper border of value* | 10 |\n"
+            "\n"
+            "`name`\n"
+            "\n"
+            "**Description:** Name of the object.\n"
+            "\n"
+            "| attribute | value |\n"
+            "| --- | --- |\n"
+            "| *Type* | String |\n"
+            "| *Required* | True |\n"
+            "| *Must match the regex* | [a-z]+ |\n"
+            "| *Minimum string-length* | 4 |\n"
+            "| *Maximum string-length* | 32 |\n"
+            "\n"
+            "**Response-Parameter**\n"
+            "\n"
+            "\n"
+            "`uuid`\n"
+            "\n"
+            "**Description:** UUID of the object.\n"
+            "\n"
+            "| attribute | value |\n"
+            "| --- | --- |\n"
+            "| *Type* | String |\n";
+
+    const std::string expected =
+            "## docu_test\n"
+            "\n"
+            "\n"
+            "### v1/docu_test/list\n"
+            "\n"
+            "#### GET\n"
+            "\n"
+            + blossomPart
+            + "\n"
+              "### v1/docu_test/object\n"
+              "\n"
+              "#### POST\n"
+              "\n"
+            + blossomPart;
+
+    std::string docu;
+    DocuRenderer<MdFormat>::render(docu, "docu_test", getTestFilter());
+    TEST_EQUAL(docu, expected);
+}
+
+/**
+ * @brief filter_test
+ */
+void
+DocuRenderer_Test::filter_test()
+{
+    std::string allDocu;
+    DocuRenderer<RstFormat>::render(allDocu, "docu_test", getTestFilter());
+
+    // select only the post-endpoint by http-type
+    DocuFilter postFilter = getTestFilter();
+    postFilter.httpTypes = 1u << Hanami::POST_TYPE;
+    std::string postDocu;
+    DocuRenderer<RstFormat>::render(postDocu, "docu_test", postFilter);
+
+    // select the same endpoint by offset
+    DocuFilter offsetFilter = getTestFilter();
+    offsetFilter.offset = 1;
+    std::string offsetDocu;
+    DocuRenderer<RstFormat>::render(offsetDocu, "docu_test", offsetFilter);
+
+    TEST_EQUAL(postDocu, offsetDocu);
+    TEST_EQUAL(postDocu.find("v1/docu_test/list"), std::string::npos);
+    TEST_NOT_EQUAL(postDocu.find("v1/docu_test/object"), std::string::npos);
+
+    // without a matching group only the title is left
+    DocuFilter groupFilter = getTestFilter();
+    groupFilter.group = "other_group";
+    std::string groupDocu;
+    DocuRenderer<RstFormat>::render(groupDocu, "docu_test", groupFilter);
+    TEST_EQUAL(groupDocu, std::string("DOCU_TEST\n=========\n\n"));
+
+    // the limit cuts after the first endpoint
+    DocuFilter limitFilter = getTestFilter();
+    limitFilter.limit = 1;
+    std::string limitDocu;
+    DocuRenderer<RstFormat>::render(limitDocu, "docu_test", limitFilter);
+    TEST_EQUAL(limitDocu.size() + postDocu.size(), allDocu.size() + groupDocu.size());
+}
+
+/**
+ * @brief size_test
+ */
+void
+DocuRenderer_Test::size_test()
+{
+    const DocuFilter filter = getTestFilter();
+
+    std::string rstDocu;
+    DocuRenderer<RstFormat>::render(rstDocu, "docu_test", filter);
+    TEST_EQUAL(DocuRenderer<RstFormat>::calcSize("docu_test", filter), rstDocu.size());
+
+    std::string mdDocu;
+    DocuRenderer<MdFormat>::render(mdDocu, "docu_test", filter);
+    TEST_EQUAL(DocuRenderer<MdFormat>::calcSize("docu_test", filter), mdDocu.size());
+}
+
+/**
+ * @brief stream_test
+ */
+void
+DocuRenderer_Test::stream_test()
+{
+    const DocuFilter filter = getTestFilter();
+
+    std::string docu;
+    DocuRenderer<RstFormat>::render(docu, "docu_test", filter);
+
+    std::string expectedBase64;
+    appendBase64(expectedBase64, docu.c_str(), docu.size());
+
+    // small chunks, so the document is cut multiple times
+    for(const uint64_t chunkSize : {1, 3, 7, 64, 64 * 1024})
+    {
+        std::string rawOutput;
+        DocuStream rawStream(rawOutput, false, chunkSize);
+        DocuRenderer<RstFormat>::render(rawStream, "docu_test", filter);
+        TEST_EQUAL(rawOutput, docu);
+        TEST_EQUAL(rawStream.getRawSize(), docu.size());
+
+        std::string encodedOutput;
+        DocuStream encodedStream(encodedOutput, true, chunkSize);
+        DocuRenderer<RstFormat>::render(encodedStream, "docu_test", filter);
+        TEST_EQUAL(encodedOutput, expectedBase64);
+    }
+}
+
+}  // namespace Misaki
@@ -0,0 +1,47 @@
+/**
+ * @file        docu_renderer_test.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_DOCU_RENDERER_TEST_H
+#define KITSUNEMIMI_HANAMI_MISAKI_DOCU_RENDERER_TEST_H
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Misaki
+{
+
+class DocuRenderer_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    DocuRenderer_Test();
+
+private:
+    void renderRst_test();
+    void renderMd_test();
+    void filter_test();
+    void size_test();
+    void stream_test();
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_DOCU_RENDERER_TEST_H
@@ -0,0 +1,233 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+#include <libMisakiGuard/misaki_input.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiCommon/config.h>
+#include <libKitsunemimiConfig/config_handler.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+struct LoadSettings
+{
+    uint32_t numberOfThreads = 100;
+    uint32_t durationSec = 10;
+    uint32_t numberOfComponents = 1;
+    bool clearCache = false;
+};
+
+struct ThreadResult
+{
+    std::vector<uint32_t> latenciesUs;
+    uint64_t errors = 0;
+};
+
+/**
+ * @brief print usage of the tool
+ */
+static void
+printUsage()
+{
+    std::cout << "usage: load_generator --config <file> [options]\n"
+              << "    --threads <n>      number of parallel callers (default 100)\n"
+              << "    --duration <s>     duration of the test (default 10)\n"
+              << "    --components <n>   number of different component-names (default 1)\n"
+              << "    --clear-cache      clear the token-cache before the test starts"
+              << std::endl;
+}
+
+/**
+ * @brief request internal tokens in a loop until the end of the test is reached
+ */
+static void
+runCaller(ThreadResult* result,
+          const LoadSettings settings,
+          const uint32_t threadId,
+          const std::chrono::steady_clock::time_point end)
+{
+    uint64_t counter = threadId;
+    while(std::chrono::steady_clock::now() < end)
+    {
+        const std::string componentName = "load_generator_"
+                                          + std::to_string(counter % settings.numberOfComponents);
+        counter++;
+
+        std::string token;
+        ErrorContainer error;
+        const auto start = std::chrono::steady_clock::now();
+        const bool success = Misaki::getInternalToken(token, componentName, error);
+        const auto duration = std::chrono::steady_clock::now() - start;
+
+        result->latenciesUs.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+        if(success == false) {
+            result->errors++;
+        }
+    }
+}
+
+/**
+ * @brief get percentile of a sorted list
+ */
+static uint32_t
+getPercentile(const std::vector<uint32_t> &sorted,
+              const double percentile)
+{
+    if(sorted.size() == 0) {
+        return 0;
+    }
+
+    const uint64_t pos = static_cast<uint64_t>(percentile * static_cast<double>(sorted.size()));
+    return sorted.at(std::min<uint64_t>(pos, sorted.size() - 1));
+}
+
+int
+main(int argc, char *argv[])
+{
+    LoadSettings settings;
+    std::string configFile = "";
+
+    // parse arguments
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string key = argv[i];
+        if(key == "--clear-cache")
+        {
+            settings.clearCache = true;
+            continue;
+        }
+        if(i + 1 >= argc)
+        {
+            printUsage();
+            return 1;
+        }
+
+        const std::string value = argv[++i];
+
+        // stoul throws, if the value is not a number
+        try
+        {
+            if(key == "--config") {
+                configFile = value;
+            } else if(key == "--threads") {
+                settings.numberOfThreads = static_cast<uint32_t>(std::stoul(value));
+            } else if(key == "--duration") {
+                settings.durationSec = static_cast<uint32_t>(std::stoul(value));
+            } else if(key == "--components") {
+                settings.numberOfComponents = std::max<uint32_t>(1, std::stoul(value));
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+        catch(const std::exception &)
+        {
+            std::cout << "invalid value '" << value << "' for argument " << key << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if(configFile == "")
+    {
+        printUsage();
+        return 1;
+    }
+
+    initConsoleLogger(false);
+
+    // init config and connect to the misaki-stand-in
+    ErrorContainer error;
+    if(Config::initConfig(configFile, error) == false
+            || Hanami::registerBasicConfigs(error) == false)
+    {
+        LOG_ERROR(error);
+        return 1;
+    }
+
+    HanamiMessaging* messaging = HanamiMessaging::getInstance();
+    const std::vector<std::string> groupNames = {};
+    if(messaging->initialize("load_generator",
+                             groupNames,
+                             nullptr,
+                             nullptr,
+                             nullptr,
+                             error,
+                             false) == false)
+    {
+        LOG_ERROR(error);
+        return 1;
+    }
+
+    // clear only once, because parallel clears would measure the cache-clearing instead of
+    // the token-requests
+    if(settings.clearCache) {
+        Misaki::clearInternalTokenCache();
+    }
+
+    // run callers
+    std::vector<ThreadResult> results(settings.numberOfThreads);
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::seconds(settings.durationSec);
+    for(uint32_t i = 0; i < settings.numberOfThreads; i++) {
+        threads.emplace_back(runCaller, &results[i], settings, i, end);
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    const double durationSec = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start).count();
+
+    // merge results
+    std::vector<uint32_t> latencies;
+    uint64_t errors = 0;
+    for(const ThreadResult &result : results)
+    {
+        latencies.insert(latencies.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+        errors += result.errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "{\"threads\":" << settings.numberOfThreads
+              << ",\"components\":" << settings.numberOfComponents
+              << ",\"clear_cache\":" << (settings.clearCache ? "true" : "false")
+              << ",\"requests\":" << latencies.size()
+              << ",\"errors\":" << errors
+              << ",\"throughput_per_s\":" << static_cast<double>(latencies.size()) / durationSec
+              << ",\"p50_us\":" << getPercentile(latencies, 0.5)
+              << ",\"p99_us\":" << getPercentile(latencies, 0.99)
+              << ",\"p999_us\":" << getPercentile(latencies, 0.999)
+              << ",\"max_us\":" << (latencies.size() > 0 ? latencies.back() : 0)
+              << "}" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file        create_internal_token.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "create_internal_token.h"
+
+#include <chrono>
+#include <thread>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+#include <libKitsunemimiCrypto/common.h>
+#include <libKitsunemimiJson/json_item.h>
+
+using namespace Kitsunemimi;
+
+namespace Misaki
+{
+
+/**
+ * @brief convert a string into base64url without padding, like it is used within jwt-tokens
+ */
+static std::string
+encodeBase64Url(const std::string &input)
+{
+    std::string output;
+    encodeBase64(output, input.c_str(), input.size());
+
+    while(output.size() > 0
+          && output.back() == '=')
+    {
+        output.pop_back();
+    }
+    for(char &c : output)
+    {
+        if(c == '+') {
+            c = '-';
+        } else if(c == '/') {
+            c = '_';
+        }
+    }
+
+    return output;
+}
+
+CreateInternalToken::CreateInternalToken(const StandInSettings &settings)
+    : Hanami::Blossom("Create internal jwt-token with configurable latency and error-rate."),
+      m_settings(settings),
+      m_random(std::random_device()())
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("service_name",
+                       Hanami::SAKURA_STRING_TYPE,
+                       true,
+                       "Name of the component where the token is for.");
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("token",
+                        Hanami::SAKURA_STRING_TYPE,
+                        "Internal jwt-token.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief get random value between 0.0 and 1.0
+ */
+double
+CreateInternalToken::getRandom()
+{
+    std::lock_guard<std::mutex> guard(m_randomLock);
+    return std::uniform_real_distribution<double>(0.0, 1.0)(m_random);
+}
+
+/**
+ * @brief runTask
+ */
+bool
+CreateInternalToken::runTask(Hanami::BlossomIO &blossomIO,
+                             const DataMap &,
+                             Hanami::BlossomStatus &status,
+                             ErrorContainer &error)
+{
+    // simulate a misaki, which doesn't answer in time
+    if(getRandom() < m_settings.timeoutRate)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_settings.timeoutMs));
+    }
+    else
+    {
+        const uint32_t jitter = static_cast<uint32_t>(getRandom() * m_settings.latencyJitterMs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_settings.latencyMs + jitter));
+    }
+
+    // simulate internal errors of misaki
+    if(getRandom() < m_settings.errorRate)
+    {
+        status.statusCode = Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        status.errorMessage = "simulated error of the misaki-stand-in";
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // create token
+    const std::string serviceName = blossomIO.input.get("service_name").getString();
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const long expireTime = std::chrono::duration_cast<std::chrono::seconds>(now).count()
+                            + static_cast<long>(m_settings.tokenLifetime);
+
+    JsonItem header;
+    header.insert("alg", JsonItem("HS256"));
+    header.insert("typ", JsonItem("JWT"));
+
+    // build payload as json-item, so the service-name is escaped correctly
+    JsonItem payload;
+    payload.insert("exp", JsonItem(expireTime));
+    payload.insert("service_name", JsonItem(serviceName));
+
+    const std::string token = encodeBase64Url(header.toString())
+                              + "." + encodeBase64Url(payload.toString())
+                              + "." + encodeBase64Url("misaki-stand-in");
+
+    blossomIO.output.insert("token", token);
+
+    return true;
+}
+
+}  // namespace Misaki
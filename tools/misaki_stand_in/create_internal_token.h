@@ -0,0 +1,71 @@
+/**
+ * @file        create_internal_token.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_MISAKI_CREATE_INTERNAL_TOKEN_H
+#define KITSUNEMIMI_HANAMI_MISAKI_CREATE_INTERNAL_TOKEN_H
+
+#include <random>
+#include <mutex>
+
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+
+namespace Misaki
+{
+
+struct StandInSettings
+{
+    uint32_t latencyMs = 0;
+    uint32_t latencyJitterMs = 0;
+    double errorRate = 0.0;
+    double timeoutRate = 0.0;
+    uint32_t timeoutMs = 30000;
+    uint32_t tokenLifetime = 3600;
+};
+
+/**
+ * Replacement for the blossom of misaki, which creates internal jwt-tokens. The tokens have
+ * a valid structure and exp-claim, but are not signed, so they are only usable for the
+ * internal-token-path of the guard.
+ */
+class CreateInternalToken
+        : public Kitsunemimi::Hanami::Blossom
+{
+public:
+    CreateInternalToken(const StandInSettings &settings);
+
+protected:
+    bool runTask(Kitsunemimi::Hanami::BlossomIO &blossomIO,
+                 const Kitsunemimi::DataMap &context,
+                 Kitsunemimi::Hanami::BlossomStatus &status,
+                 Kitsunemimi::ErrorContainer &error);
+
+private:
+    const StandInSettings m_settings;
+    std::mt19937_64 m_random;
+    std::mutex m_randomLock;
+
+    double getRandom();
+};
+
+}  // namespace Misaki
+
+#endif // KITSUNEMIMI_HANAMI_MISAKI_CREATE_INTERNAL_TOKEN_H
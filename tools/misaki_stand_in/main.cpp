@@ -0,0 +1,148 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "create_internal_token.h"
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <exception>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiCommon/config.h>
+#include <libKitsunemimiConfig/config_handler.h>
+
+using namespace Kitsunemimi;
+using Kitsunemimi::Hanami::HanamiMessaging;
+
+/**
+ * @brief print usage of the tool
+ */
+static void
+printUsage()
+{
+    std::cout << "usage: misaki_stand_in --config <file> [options]\n"
+              << "    --latency-ms <ms>          base-latency of each request (default 0)\n"
+              << "    --latency-jitter-ms <ms>   random additional latency (default 0)\n"
+              << "    --error-rate <0.0-1.0>     rate of failing requests (default 0.0)\n"
+              << "    --timeout-rate <0.0-1.0>   rate of requests, which hang (default 0.0)\n"
+              << "    --timeout-ms <ms>          time, how long hanging requests wait "
+                 "(default 30000)\n"
+              << "    --lifetime <s>             lifetime of the created tokens (default 3600)"
+              << std::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+    Misaki::StandInSettings settings;
+    std::string configFile = "";
+
+    // parse arguments
+    for(int i = 1; i < argc; i += 2)
+    {
+        const std::string key = argv[i];
+        if(i + 1 >= argc)
+        {
+            std::cout << "missing value for argument " << key << std::endl;
+            printUsage();
+            return 1;
+        }
+        const std::string value = argv[i + 1];
+
+        // stoul and stod throw, if the value is not a number
+        try
+        {
+            if(key == "--config") {
+                configFile = value;
+            } else if(key == "--latency-ms") {
+                settings.latencyMs = static_cast<uint32_t>(std::stoul(value));
+            } else if(key == "--latency-jitter-ms") {
+                settings.latencyJitterMs = static_cast<uint32_t>(std::stoul(value));
+            } else if(key == "--error-rate") {
+                settings.errorRate = std::stod(value);
+            } else if(key == "--timeout-rate") {
+                settings.timeoutRate = std::stod(value);
+            } else if(key == "--timeout-ms") {
+                settings.timeoutMs = static_cast<uint32_t>(std::stoul(value));
+            } else if(key == "--lifetime") {
+                settings.tokenLifetime = static_cast<uint32_t>(std::stoul(value));
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+        catch(const std::exception &)
+        {
+            std::cout << "invalid value '" << value << "' for argument " << key << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if(configFile == "")
+    {
+        printUsage();
+        return 1;
+    }
+
+    initConsoleLogger(false);
+
+    // init config
+    ErrorContainer error;
+    if(Config::initConfig(configFile, error) == false
+            || Hanami::registerBasicConfigs(error) == false)
+    {
+        LOG_ERROR(error);
+        return 1;
+    }
+
+    // start messaging-server under the name of misaki
+    HanamiMessaging* messaging = HanamiMessaging::getInstance();
+    const std::vector<std::string> groupNames = {};
+    if(messaging->initialize("misaki", groupNames, nullptr, nullptr, nullptr, error, true) == false)
+    {
+        LOG_ERROR(error);
+        return 1;
+    }
+
+    // register the only endpoint, which is used by the internal-token-path of the guard
+    const std::string group = "token";
+    if(messaging->addBlossom(group,
+                             "create_internal",
+                             new Misaki::CreateInternalToken(settings)) == false
+            || messaging->addEndpoint("v1/token/internal",
+                                      Hanami::POST_TYPE,
+                                      Hanami::BLOSSOM_TYPE,
+                                      group,
+                                      "create_internal") == false)
+    {
+        std::cout << "failed to register endpoint v1/token/internal" << std::endl;
+        return 1;
+    }
+
+    std::cout << "misaki-stand-in is running" << std::endl;
+    while(true) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    return 0;
+}